@@ -0,0 +1,236 @@
+"""
+This script measures the bandwidth of a memory range interleaved between
+local DRAM and DRAM behind a CXL memory device, like the weighted
+interleave memory policy of Linux does between DRAM and CXL nodes, but in
+hardware.
+
+Traffic generators stream through the interleaved range, which a
+WeightedInterleaveAddrMapper stripes across the local DRAM and the CXL
+bridge. With `--weights 3:1`, three of every four stripes go to the local
+DRAM and one to the CXL memory. The bandwidth each side delivers is in the
+stats of the local and CXL memory controllers, so the aggregate bandwidth
+of several weights can be compared for bandwidth-bound workloads such as
+STREAM:
+
+```
+scons build/X86/gem5.opt
+./build/X86/gem5.opt \
+    configs/example/gem5_library/cxl-interleave-traffic.py \
+    LinearGenerator 100 --weights 3:1
+```
+"""
+
+import argparse
+from typing import (
+    List,
+    Sequence,
+    Tuple,
+)
+
+from m5.objects import (
+    AddrRange,
+    MemCtrl,
+    NoncoherentXBar,
+    Port,
+    WeightedInterleaveAddrMapper,
+)
+from m5.util.convert import toMemorySize
+
+from gem5.components.boards.abstract_board import AbstractBoard
+from gem5.components.boards.test_board import TestBoard
+from gem5.components.cachehierarchies.classic.no_cache import NoCache
+from gem5.components.memory.abstract_memory_system import AbstractMemorySystem
+from gem5.components.memory.cxl_expander import CXLExpander
+from gem5.components.memory.multi_channel import DualChannelDDR4_2400
+from gem5.components.memory.single_channel import SingleChannelDDR4_2400
+from gem5.components.processors.linear_generator import LinearGenerator
+from gem5.components.processors.random_generator import RandomGenerator
+from gem5.simulate.simulator import Simulator
+from gem5.utils.override import overrides
+
+# The CXL memory is mapped behind the interleaver at the first multiple of
+# this above the local DRAM.
+CXL_ALIGN = toMemorySize("4GiB")
+
+
+class DRAMCXLInterleave(AbstractMemorySystem):
+    """
+    A memory range striped across local DRAM and DRAM behind a CXL memory
+    device, in proportion to their weights.
+
+    The interleaver packs the stripes of each side into its own range
+    behind a crossbar: the local DRAM from address zero, and the CXL
+    memory from the first multiple of CXL_ALIGN above it, followed by the
+    control registers of the CXL device.
+    """
+
+    def __init__(
+        self, size: str, weights: Tuple[int, int], granularity: str
+    ) -> None:
+        super().__init__()
+        self._size = toMemorySize(size)
+        self._weights = weights
+        self._granularity = toMemorySize(granularity)
+        self._range = None
+
+        round_bytes = sum(weights) * self._granularity
+        if self._size % round_bytes:
+            raise ValueError(
+                f"The size must be a multiple of {round_bytes} bytes, one "
+                "round of stripes."
+            )
+        local_size = self._size // sum(weights) * weights[0]
+        cxl_size = self._size // sum(weights) * weights[1]
+
+        self._local_range = AddrRange(0, size=local_size)
+        cxl_base = (local_size + CXL_ALIGN - 1) // CXL_ALIGN * CXL_ALIGN
+        self._cxl_range = AddrRange(cxl_base, size=cxl_size)
+
+        self._local = DualChannelDDR4_2400(f"{local_size}B")
+        self.local = self._local
+        self._cxl = CXLExpander(
+            SingleChannelDDR4_2400(f"{cxl_size}B"),
+            ctrl_reg_range=AddrRange(self._cxl_range.end, size="64KiB"),
+        )
+        self.cxl = self._cxl
+
+        self.interleaver = WeightedInterleaveAddrMapper(
+            weights=list(weights), granularity=self._granularity
+        )
+        self.mem_bus = NoncoherentXBar(
+            width=64,
+            frontend_latency=1,
+            forward_latency=1,
+            response_latency=1,
+        )
+        self.interleaver.mem_side_port = self.mem_bus.cpu_side_ports
+        for _, port in self._local.get_mem_ports():
+            self.mem_bus.mem_side_ports = port
+        for _, port in self._cxl.get_mem_ports():
+            self.mem_bus.mem_side_ports = port
+
+    @overrides(AbstractMemorySystem)
+    def incorporate_memory(self, board: AbstractBoard) -> None:
+        if self._granularity < int(board.get_cache_line_size()):
+            raise ValueError(
+                "The interleaving granularity can not be smaller than the "
+                "board's cache line size."
+            )
+        self._local.incorporate_memory(board)
+        self._cxl.incorporate_memory(board)
+
+    @overrides(AbstractMemorySystem)
+    def get_mem_ports(self) -> Sequence[Tuple[AddrRange, Port]]:
+        return [(self._range, self.interleaver.cpu_side_port)]
+
+    @overrides(AbstractMemorySystem)
+    def get_memory_controllers(self) -> List[MemCtrl]:
+        return (
+            self._local.get_memory_controllers()
+            + self._cxl.get_memory_controllers()
+        )
+
+    @overrides(AbstractMemorySystem)
+    def get_size(self) -> int:
+        return self._size
+
+    @overrides(AbstractMemorySystem)
+    def set_memory_range(self, ranges: List[AddrRange]) -> None:
+        if len(ranges) != 1 or ranges[0].size() != self._size:
+            raise Exception(
+                "DRAMCXLInterleave requires a single range which matches "
+                "its size."
+            )
+        self._local.set_memory_range([self._local_range])
+        self._cxl.set_memory_range([self._cxl_range])
+
+        self._range = ranges[0]
+        self.interleaver.interleaved_range = ranges[0]
+        self.interleaver.remapped_ranges = [
+            self._local_range,
+            self._cxl_range,
+        ]
+
+
+def parse_weights(weights: str) -> Tuple[int, int]:
+    local, cxl = (int(weight) for weight in weights.split(":"))
+    if local <= 0 or cxl <= 0:
+        raise argparse.ArgumentTypeError("the weights must be positive")
+    return local, cxl
+
+
+parser = argparse.ArgumentParser(
+    description="Traffic generators streaming through memory interleaved "
+    "between local DRAM and CXL memory."
+)
+
+parser.add_argument(
+    "generator_class",
+    type=str,
+    help="The class of generator to use.",
+    choices=["LinearGenerator", "RandomGenerator"],
+)
+
+parser.add_argument(
+    "read_percentage",
+    type=int,
+    help="Percentage of read requests in the generated traffic.",
+)
+
+parser.add_argument(
+    "--weights",
+    type=parse_weights,
+    default=(1, 1),
+    help="Weights of the local DRAM and the CXL memory, as LOCAL:CXL.",
+)
+
+parser.add_argument(
+    "--granularity",
+    type=str,
+    default="4KiB",
+    help="Size of the stripes.",
+)
+
+parser.add_argument(
+    "--size",
+    type=str,
+    default="1GiB",
+    help="Size of the interleaved memory.",
+)
+
+parser.add_argument(
+    "--num_generators",
+    type=int,
+    default=4,
+    help="Number of traffic generators.",
+)
+
+args = parser.parse_args()
+
+if args.read_percentage > 100 or args.read_percentage < 0:
+    parser.error("the read percentage must be between 0 and 100")
+
+memory = DRAMCXLInterleave(args.size, args.weights, args.granularity)
+
+generator_class = (
+    LinearGenerator
+    if args.generator_class == "LinearGenerator"
+    else RandomGenerator
+)
+generator = generator_class(
+    num_cores=args.num_generators,
+    duration="1ms",
+    rate="32GiB/s",
+    max_addr=memory.get_size(),
+    rd_perc=args.read_percentage,
+)
+
+board = TestBoard(
+    clk_freq="3GHz",
+    generator=generator,
+    memory=memory,
+    cache_hierarchy=NoCache(),
+)
+
+simulator = Simulator(board=board)
+simulator.run()
@@ -31,6 +31,45 @@ using the gem5 library and defaults to simulating CXL ASIC Device.
 This simulation boots Ubuntu 18.04 using 1 Atomic CPU
 cores. The simulation then switches to 1 TIMING CPU core to run the lmbench_cxl.sh.
 
+The boot may instead be fast-forwarded with KVM cores (`--ff_cpu_type KVM`).
+The CXL memory is part of the board memories, so KVM maps it into the guest
+like the host DRAM and the CXL link is only modelled after the switch.
+KVM is the fast path for CXL memory: the Atomic cores boot through the
+caches, which do not pass backdoors on, so each of their CXL accesses still
+takes the full atomic path of the bridge and the device.
+Under KVM, CXL accesses are not timed at all, like any other memory access
+of a KVM core. Cores that do use backdoors, such as non-caching Atomic cores,
+are charged for each fetch through a CXL backdoor the latency of the access
+that got it, which includes the link, the protocol and the media.
+With `--kvm_warm_pages` the caches are warmed with the pages written last
+under KVM before the switch, instead of starting cold.
+
+With `--cxl_thread` the CXL device and its memory are simulated by a second
+host thread, synchronised with the host side every CXL bridge latency. This
+combines with KVM: each KVM core runs on a host thread of its own, e.g.
+`--ff_cpu_type KVM --num_cpus 48 --cxl_thread` boots 48 cores at near
+native speed, and the simulation quantum only drops to the bridge latency
+once the cores are switched. CXL accesses go through the same bridge and
+I/O crossbar as without `--cxl_thread`. The other I/O gets a bridge of its
+own and no longer contends with them; the two modes have not been compared
+by their stats yet.
+
+With `--cxl_sparse` only the written pages of the CXL memory take host
+memory, so `--cxl_size` may be far larger than the host memory, e.g.
+`--cxl_size 1TiB`. The host memory it takes is reported, once per backing
+store, in the backingStore.hostResident stats of the board.
+
+With `--samples` the benchmark is sampled rather than fully simulated: the
+Atomic cores fast-forward, warming the caches and the CXL path, and every
+`--sample_period` ticks the detailed cores run a short warm-up and a
+measured interval. The estimates are written to `sampling.json`.
+
+To see where the host time before the first simulated tick goes, run gem5
+with `--startup-profile startup.json`, which writes the host seconds of each
+startup phase, from the config script to initState and startup. Compare the
+files of two builds to measure a change to the startup path. No startup
+optimization has been made or measured for this script yet.
+
 Usage
 -----
 
@@ -52,6 +91,7 @@ from gem5.components.processors.cpu_types import CPUTypes
 from gem5.isas import ISA
 from gem5.simulate.simulator import Simulator
 from gem5.simulate.exit_event import ExitEvent
+from gem5.simulate.sampling import SmartsSampler
 from gem5.resources.resource import DiskImageResource, KernelResource
 
 # This runs a check to ensure the gem5 binary is compiled to X86 and to the
@@ -75,10 +115,25 @@ parser.add_argument('--test_cmd', type=str, choices=['lmbench_cxl.sh',
                                                      ], default='lmbench_cxl.sh', help='Choose a test to run.')
 parser.add_argument('--num_cpus', type=int, default=1, help='Number of CPUs')
 parser.add_argument('--cpu_type', type=str, choices=['TIMING', 'O3'], default='TIMING', help='CPU type')
+parser.add_argument('--ff_cpu_type', type=str, choices=['ATOMIC', 'KVM'], default='ATOMIC', help='CPU type used to fast-forward the boot')
+parser.add_argument('--kvm_warm_pages', type=int, default=0, help='Number of pages written last under KVM to warm the caches with before the switch')
+parser.add_argument('--cxl_thread', action='store_true', help='Simulate the CXL device and its memory on a separate host thread')
+parser.add_argument('--l3_vector_tag_lookup', action='store_true', help='Look the L3 tags up in a vectorized tag array')
+parser.add_argument('--skip_stalled_cycles', action='store_true', help='Let the O3 cores stop ticking while they are stalled on memory')
+parser.add_argument('--samples', type=int, default=0, help='Number of samples of a sampled run of the benchmark, which is fully simulated if 0')
+parser.add_argument('--sample_period', type=int, default=1000000000, help='Ticks between two samples')
+parser.add_argument('--sample_warmup', type=int, default=10000000, help='Ticks of detailed warm-up before each sample')
+parser.add_argument('--sample_length', type=int, default=10000000, help='Ticks of each sample')
+parser.add_argument('--cxl_size', type=str, default='8GB', help='CXL memory size')
+parser.add_argument('--cxl_sparse', action='store_true', help='Only back the written pages of the CXL memory with host memory')
+parser.add_argument('--cxl_dedup', action='store_true', help='Let the host merge identical pages of the sparse CXL memory')
 parser.add_argument('--cxl_mem_type', type=str, choices=['Simple', 'DRAM'], default='DRAM', help='CXL memory type')
 
 args = parser.parse_args()
 
+if args.samples and args.ff_cpu_type == 'KVM':
+    parser.error("Sampling needs Atomic cores to warm the caches")
+
 # Here we setup a MESI Three Level Cache Hierarchy.
 cache_hierarchy = PrivateL1PrivateL2SharedL3CacheHierarchy(
     l1d_size="48kB",
@@ -89,14 +144,15 @@ cache_hierarchy = PrivateL1PrivateL2SharedL3CacheHierarchy(
     l2_assoc=16,
     l3_size="96MB",
     l3_assoc=48,
+    l3_vector_tag_lookup=args.l3_vector_tag_lookup,
 )
 
 # Setup the system memory.
 memory = DIMM_DDR5_4400(size="3GB")
 if args.is_asic:
-    cxl_memory = DIMM_DDR5_4400(size="8GB")
+    cxl_memory = DIMM_DDR5_4400(size=args.cxl_size)
 else:
-    cxl_memory = SingleChannelDDR4_3200(size="8GB")
+    cxl_memory = SingleChannelDDR4_3200(size=args.cxl_size)
 # Here we setup the processor. This is a special switchable processor in which
 # a starting core type and a switch core type must be specified. Once a
 # configuration is instantiated a user may call `processor.switch()` to switch
@@ -105,12 +161,19 @@ else:
 # cores for the command we wish to run after boot.
 
 processor = SimpleSwitchableProcessor(
-    starting_core_type=CPUTypes.ATOMIC,
+    starting_core_type=CPUTypes.KVM if args.ff_cpu_type == 'KVM' else CPUTypes.ATOMIC,
     switch_core_type = CPUTypes.O3 if args.cpu_type == 'O3' else CPUTypes.TIMING,
     isa=ISA.X86,
     num_cores=args.num_cpus,
 )
 
+if args.kvm_warm_pages and args.ff_cpu_type == 'KVM':
+    processor.set_kvm_cache_warming(args.kvm_warm_pages)
+
+if args.skip_stalled_cycles and args.cpu_type == 'O3':
+    for core in processor._switchable_cores["switch"]:
+        core.get_simobject().skip_stalled_cycles = True
+
 # Here we setup the board and CXL device memory size. The X86Board allows for Full-System X86 simulations.
 board = X86Board(
     clk_freq="2.4GHz",
@@ -118,7 +181,10 @@ board = X86Board(
     memory=memory,
     cache_hierarchy=cache_hierarchy,
     cxl_memory=cxl_memory,
-    is_asic=(args.is_asic == 'True')
+    is_asic=(args.is_asic == 'True'),
+    cxl_eventq_index=1 if args.cxl_thread else None,
+    cxl_sparse_backing=args.cxl_sparse,
+    cxl_dedup_backing=args.cxl_dedup,
 )
 
 # Here we set the Full System workload.
@@ -144,15 +210,29 @@ board.set_kernel_disk_workload(
     readfile_contents=command,
 )
 
+def start_sampling():
+    simulator.schedule_sampling(
+        SmartsSampler(
+            processor=processor,
+            period=args.sample_period,
+            detailed_warmup=args.sample_warmup,
+            measurement=args.sample_length,
+            num_samples=args.samples,
+        )
+    )
+    yield False
+
+
 simulator = Simulator(
     board=board,
     on_exit_event={
-        ExitEvent.EXIT: (func() for func in [processor.switch])
+        ExitEvent.EXIT: start_sampling() if args.samples
+        else (func() for func in [processor.switch])
     },
 )
 
 print("Running the simulation")
-print("Using Atomic cpu")
+print("Using " + args.ff_cpu_type.capitalize() + " cpu")
 
 m5.stats.reset()
 
@@ -0,0 +1,278 @@
+#include "base/binary_trace.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace binary_trace
+{
+
+namespace
+{
+
+/**
+ * Layout of a trace file: a FileHeader followed by blocks, each a
+ * BlockHeader and its payload. A name block holds the characters of
+ * one name. A record block holds the records of one host thread, so
+ * the records of a thread are in order but the blocks of different
+ * threads interleave.
+ */
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+};
+
+enum BlockKind : uint32_t
+{
+    ObjectName = 1,
+    EventName = 2,
+    CmdName = 3,
+    Records = 4,
+};
+
+struct BlockHeader
+{
+    uint32_t kind;
+    /** Id of the name, or thread of the records. */
+    uint32_t id;
+    /** Length of the name, or number of records. */
+    uint64_t size;
+};
+
+const char magic[8] = {'g', 'e', 'm', '5', 'b', 't', 'r', '\0'};
+
+struct Buffer
+{
+    /**
+     * Taken by the thread appending and by the writers, which already hold
+     * the lock of the output.
+     */
+    std::mutex lock;
+    uint32_t thread;
+    std::vector<Record> records;
+};
+
+class Output
+{
+  public:
+    std::mutex lock;
+
+    /** Set when records go to the file rather than the logger. */
+    std::atomic<bool> active{false};
+
+    std::FILE *file = nullptr;
+
+    std::vector<std::string> objects;
+    std::vector<std::string> events;
+    std::unordered_map<std::string, uint32_t> objectIds;
+    std::unordered_map<std::string, uint16_t> eventIds;
+    std::unordered_map<uint16_t, std::string> cmds;
+
+    /** Buffers of all threads, kept until the end of the simulation. */
+    std::vector<Buffer *> buffers;
+
+    ~Output()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        close();
+    }
+
+    void
+    writeName(BlockKind kind, uint32_t id, const std::string &name)
+    {
+        if (!file)
+            return;
+        BlockHeader header = {kind, id, name.size()};
+        std::fwrite(&header, sizeof(header), 1, file);
+        std::fwrite(name.data(), 1, name.size(), file);
+    }
+
+    void
+    writeRecords(Buffer &buffer)
+    {
+        std::lock_guard<std::mutex> guard(buffer.lock);
+        if (file && !buffer.records.empty()) {
+            BlockHeader header = {Records, buffer.thread,
+                                  buffer.records.size()};
+            std::fwrite(&header, sizeof(header), 1, file);
+            std::fwrite(buffer.records.data(), sizeof(Record),
+                        buffer.records.size(), file);
+        }
+        buffer.records.clear();
+    }
+
+    void
+    close()
+    {
+        for (Buffer *buffer : buffers)
+            writeRecords(*buffer);
+        if (file)
+            std::fclose(file);
+        file = nullptr;
+        active = false;
+    }
+
+    void
+    open(const std::string &path)
+    {
+        file = std::fopen(path.c_str(), "wb");
+        fatal_if(!file, "Cannot open binary trace file %s.", path);
+
+        FileHeader header;
+        std::copy(magic, magic + sizeof(magic), header.magic);
+        header.version = 1;
+        header.recordSize = sizeof(Record);
+        std::fwrite(&header, sizeof(header), 1, file);
+
+        for (uint32_t i = 0; i < objects.size(); i++)
+            writeName(ObjectName, i, objects[i]);
+        for (uint32_t i = 0; i < events.size(); i++)
+            writeName(EventName, i, events[i]);
+        for (const auto &cmd : cmds)
+            writeName(CmdName, cmd.first, cmd.second);
+
+        active = true;
+    }
+};
+
+Output &
+output()
+{
+    static Output out;
+    return out;
+}
+
+Buffer &
+threadBuffer()
+{
+    thread_local Buffer *buffer = nullptr;
+    if (!buffer) {
+        Output &out = output();
+        std::lock_guard<std::mutex> guard(out.lock);
+        buffer = new Buffer;
+        buffer->thread = out.buffers.size();
+        buffer->records.reserve(bufferRecords);
+        out.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+} // anonymous namespace
+
+uint32_t
+objectId(const std::string &name)
+{
+    Output &out = output();
+    std::lock_guard<std::mutex> guard(out.lock);
+
+    auto it = out.objectIds.find(name);
+    if (it != out.objectIds.end())
+        return it->second;
+
+    uint32_t id = out.objects.size();
+    out.objects.push_back(name);
+    out.objectIds.emplace(name, id);
+    out.writeName(ObjectName, id, name);
+    return id;
+}
+
+uint16_t
+eventId(const std::string &name)
+{
+    Output &out = output();
+    std::lock_guard<std::mutex> guard(out.lock);
+
+    auto it = out.eventIds.find(name);
+    if (it != out.eventIds.end())
+        return it->second;
+
+    panic_if(out.events.size() > UINT16_MAX,
+             "Too many binary trace points.");
+    uint16_t id = out.events.size();
+    out.events.push_back(name);
+    out.eventIds.emplace(name, id);
+    out.writeName(EventName, id, name);
+    return id;
+}
+
+void
+nameCmd(uint16_t cmd, const std::string &name)
+{
+    Output &out = output();
+    std::lock_guard<std::mutex> guard(out.lock);
+
+    out.cmds[cmd] = name;
+    out.writeName(CmdName, cmd, name);
+}
+
+void
+setOutput(const std::string &path)
+{
+    Output &out = output();
+    std::lock_guard<std::mutex> guard(out.lock);
+
+    out.close();
+    if (!path.empty())
+        out.open(path);
+}
+
+void
+flush()
+{
+    Output &out = output();
+    std::lock_guard<std::mutex> guard(out.lock);
+
+    for (Buffer *buffer : out.buffers)
+        out.writeRecords(*buffer);
+    if (out.file)
+        std::fflush(out.file);
+}
+
+void
+record(const char *flag, uint32_t object, uint16_t event, uint64_t addr,
+       uint16_t cmd, uint64_t arg)
+{
+    Output &out = output();
+
+    if (out.active.load(std::memory_order_relaxed)) {
+        Buffer &buffer = threadBuffer();
+        bool full;
+        {
+            std::lock_guard<std::mutex> guard(buffer.lock);
+            buffer.records.push_back(
+                    {curTick(), addr, arg, object, event, cmd});
+            full = buffer.records.size() >= bufferRecords;
+        }
+        if (full) {
+            std::lock_guard<std::mutex> guard(out.lock);
+            out.writeRecords(buffer);
+        }
+        return;
+    }
+
+    std::string object_name, event_name, cmd_name;
+    {
+        std::lock_guard<std::mutex> guard(out.lock);
+        object_name = out.objects.at(object);
+        event_name = out.events.at(event);
+        auto it = out.cmds.find(cmd);
+        cmd_name = it != out.cmds.end() ? it->second : std::to_string(cmd);
+    }
+    trace::getDebugLogger()->dprintf_flag(curTick(), object_name, flag,
+            "%s: %s addr %#x arg %d\n", event_name, cmd_name, addr, arg);
+}
+
+} // namespace binary_trace
+} // namespace gem5
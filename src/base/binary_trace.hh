@@ -0,0 +1,89 @@
+/* @file
+ * Compact binary records for trace points on hot paths
+ */
+
+#ifndef __BASE_BINARY_TRACE_HH__
+#define __BASE_BINARY_TRACE_HH__
+
+#include <cstdint>
+#include <string>
+
+#include "base/compiler.hh"
+#include "base/debug.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace binary_trace
+{
+
+/** One hit of a trace point, as stored in the trace file. */
+struct Record
+{
+    Tick tick;
+    uint64_t addr;
+    /** Argument of the trace point, e.g. a queue size or a tick. */
+    uint64_t arg;
+    uint32_t object;
+    uint16_t event;
+    uint16_t cmd;
+};
+
+static_assert(sizeof(Record) == 32, "Binary trace records must be packed");
+
+/** Number of records a thread buffers before writing them out. */
+constexpr std::size_t bufferRecords = 8192;
+
+/**
+ * Get the id of an object name, registering the name on first use.
+ * Objects should look their id up once, not on every trace point.
+ */
+uint32_t objectId(const std::string &name);
+
+/** Get the id of a trace point name, registering it on first use. */
+uint16_t eventId(const std::string &name);
+
+/** Name a command value for the decoder and the text output. */
+void nameCmd(uint16_t cmd, const std::string &name);
+
+/**
+ * Write the records to the file at path, or print them through the
+ * debug logger if the path is empty. Records that are still buffered
+ * go to the previous file first.
+ */
+void setOutput(const std::string &path);
+
+/** Write out the records buffered by all threads, safe while they record. */
+void flush();
+
+/** Slow path of BTRACE, taken when the flag of the trace point is on. */
+void record(const char *flag, uint32_t object, uint16_t event,
+            uint64_t addr, uint16_t cmd, uint64_t arg);
+
+} // namespace binary_trace
+
+/**
+ * BTRACE records a fixed size binary record when debug flag x is
+ * enabled, instead of formatting a message like DPRINTF. The records
+ * are buffered per host thread and written to the file given with
+ * --debug-binary-file, and util/decode_binary_trace.py turns them into
+ * text. Without a binary file, they are printed through the debug
+ * logger like a DPRINTF.
+ *
+ * \def BTRACE(x, object, event, addr, cmd, arg)
+ *
+ * @ingroup api_trace
+ */
+#define BTRACE(x, object, event, addr, cmd, arg) do {                   \
+    if (GEM5_UNLIKELY(TRACING_ON && ::gem5::debug::x)) {               \
+        static const uint16_t _btrace_event =                           \
+            ::gem5::binary_trace::eventId(event);                       \
+        ::gem5::binary_trace::record(#x, object, _btrace_event,         \
+                                     addr, cmd, arg);                   \
+    }                                                                   \
+} while (0)
+
+} // namespace gem5
+
+#endif // __BASE_BINARY_TRACE_HH__
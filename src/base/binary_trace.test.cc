@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "base/binary_trace.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/trace.hh"
+
+using namespace gem5;
+
+namespace gem5
+{
+namespace debug
+{
+SimpleFlag BinaryTraceTestFlag("BinaryTraceTestFlag",
+    "Exclusive debug flag for the binary trace tests");
+} // namespace debug
+} // namespace gem5
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+/** Contents of a trace file. */
+struct Trace
+{
+    std::map<uint32_t, std::string> objects;
+    std::map<uint32_t, std::string> events;
+    std::map<uint32_t, std::string> cmds;
+    std::vector<binary_trace::Record> records;
+};
+
+Trace
+readTrace(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    Trace trace;
+    EXPECT_GE(data.size(), 16);
+    EXPECT_EQ(data.substr(0, 8), std::string("gem5btr\0", 8));
+
+    size_t pos = 16;
+    while (pos < data.size()) {
+        uint32_t kind, id;
+        uint64_t size;
+        std::copy_n(&data[pos], 4, (char *)&kind);
+        std::copy_n(&data[pos + 4], 4, (char *)&id);
+        std::copy_n(&data[pos + 8], 8, (char *)&size);
+        pos += 16;
+
+        if (kind == 4) {
+            for (uint64_t i = 0; i < size; i++) {
+                binary_trace::Record record;
+                std::copy_n(&data[pos], sizeof(record), (char *)&record);
+                trace.records.push_back(record);
+                pos += sizeof(record);
+            }
+        } else {
+            std::string name = data.substr(pos, size);
+            if (kind == 1)
+                trace.objects[id] = name;
+            else if (kind == 2)
+                trace.events[id] = name;
+            else
+                trace.cmds[id] = name;
+            pos += size;
+        }
+    }
+    EXPECT_EQ(pos, data.size());
+    return trace;
+}
+
+class BinaryTraceTest : public testing::Test
+{
+  protected:
+    void
+    SetUp() override
+    {
+        trace::enable();
+        debug::BinaryTraceTestFlag.enable();
+    }
+
+    void
+    TearDown() override
+    {
+        binary_trace::setOutput("");
+        debug::BinaryTraceTestFlag.disable();
+    }
+};
+
+} // anonymous namespace
+
+/** Records and the names they refer to end up in the file. */
+TEST_F(BinaryTraceTest, WritesRecords)
+{
+    const std::string path = testing::TempDir() + "binary_trace.test.bin";
+    uint32_t early = binary_trace::objectId("early");
+    binary_trace::setOutput(path);
+    uint32_t late = binary_trace::objectId("late");
+    binary_trace::nameCmd(3, "ReadReq");
+
+    // more than fits in the buffer of the thread
+    const unsigned num_records = binary_trace::bufferRecords + 10;
+    for (unsigned i = 0; i < num_records; i++) {
+        tickHandler.setCurTick(i);
+        BTRACE(BinaryTraceTestFlag, i % 2 ? early : late, "access",
+               0x1000 + i, 3, i * 2);
+    }
+    binary_trace::setOutput("");
+
+    Trace trace = readTrace(path);
+    EXPECT_EQ(trace.objects[early], "early");
+    EXPECT_EQ(trace.objects[late], "late");
+    EXPECT_EQ(trace.cmds[3], "ReadReq");
+    ASSERT_EQ(trace.records.size(), num_records);
+    for (unsigned i = 0; i < num_records; i++) {
+        const binary_trace::Record &record = trace.records[i];
+        EXPECT_EQ(record.tick, i);
+        EXPECT_EQ(record.addr, 0x1000 + i);
+        EXPECT_EQ(record.arg, i * 2);
+        EXPECT_EQ(record.object, i % 2 ? early : late);
+        EXPECT_EQ(trace.events[record.event], "access");
+        EXPECT_EQ(record.cmd, 3);
+    }
+    std::remove(path.c_str());
+}
+
+/** Nothing is recorded while the flag is off. */
+TEST_F(BinaryTraceTest, FlagOff)
+{
+    const std::string path = testing::TempDir() + "binary_trace.test.bin";
+    uint32_t object = binary_trace::objectId("object");
+    binary_trace::setOutput(path);
+
+    debug::BinaryTraceTestFlag.disable();
+    BTRACE(BinaryTraceTestFlag, object, "access", 0x40, 0, 0);
+    binary_trace::setOutput("");
+
+    EXPECT_TRUE(readTrace(path).records.empty());
+    std::remove(path.c_str());
+}
+
+/** Without a file, the records are printed like a DPRINTF. */
+TEST_F(BinaryTraceTest, TextWithoutFile)
+{
+    std::stringstream ss;
+    trace::setDebugLogger(new trace::OstreamLogger(ss));
+
+    uint32_t object = binary_trace::objectId("printed");
+    binary_trace::nameCmd(7, "WriteReq");
+    tickHandler.setCurTick(42);
+    BTRACE(BinaryTraceTestFlag, object, "send", 0x80, 7, 5);
+
+    EXPECT_EQ(ss.str(), "     42: printed: send: WriteReq addr 0x80 arg 5\n");
+}
+
+/**
+ * Trace points per second recorded in binary and printed by DPRINTF to
+ * a discarded stream. This is a benchmark rather than a test; run it
+ * with --gtest_also_run_disabled_tests.
+ */
+TEST_F(BinaryTraceTest, DISABLED_Throughput)
+{
+    const unsigned num_records = 10000000;
+    const std::string path = testing::TempDir() + "binary_trace.bench.bin";
+    uint32_t object = binary_trace::objectId("bench");
+
+    std::ofstream null_stream("/dev/null");
+    trace::setDebugLogger(new trace::OstreamLogger(null_stream));
+    StringWrap name("bench");
+
+    for (bool binary : {false, true}) {
+        binary_trace::setOutput(binary ? path : "");
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < num_records; i++) {
+            if (binary) {
+                BTRACE(BinaryTraceTestFlag, object, "bench", i * 64, 1, i);
+            } else {
+                DPRINTF(BinaryTraceTestFlag, "bench: %s addr %#x arg %d\n",
+                        "ReadReq", i * 64, i);
+            }
+        }
+        binary_trace::flush();
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << (binary ? "BTRACE " : "DPRINTF") << ": "
+                  << num_records / secs.count() << " trace points/s\n";
+    }
+    std::remove(path.c_str());
+}
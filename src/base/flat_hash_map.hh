@@ -0,0 +1,329 @@
+/* @file
+ * Open-addressing hash map with the entries stored inline
+ */
+
+#ifndef __BASE_FLAT_HASH_MAP_HH__
+#define __BASE_FLAT_HASH_MAP_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * A hash map that keeps its entries in a single array and resolves
+ * collisions with Robin Hood linear probing, so a lookup touches a
+ * few adjacent entries rather than chasing a node per entry like
+ * std::unordered_map. Erasing shifts the following entries of the
+ * probe sequence back, so the table never holds tombstones.
+ *
+ * The interface follows std::unordered_map, with these differences:
+ *  - Keys and values must be default constructible; free slots hold
+ *    default constructed ones.
+ *  - Any insertion or erase invalidates all iterators and references.
+ *  - Iteration is in slot order, which only depends on the hash of the
+ *    keys and the history of the map.
+ *  - erase() of an iterator does not return the next iterator.
+ */
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+{
+  public:
+    typedef Key key_type;
+    typedef T mapped_type;
+    typedef std::pair<Key, T> value_type;
+    typedef std::size_t size_type;
+
+  private:
+    /**
+     * Distance of each slot's entry from its home slot, plus one. Zero
+     * marks a free slot.
+     */
+    std::vector<uint8_t> dists;
+    std::vector<value_type> slots;
+
+    /** Shift that turns a mixed hash into a slot index. */
+    unsigned shift;
+    size_type mask;
+    size_type _size;
+
+    Hash hasher;
+    KeyEqual keyEqual;
+
+    static constexpr size_type minCapacity = 16;
+    static constexpr uint8_t maxDist = 255;
+
+    size_type
+    home(const Key &key) const
+    {
+        // Fibonacci hashing spreads keys such as aligned addresses or
+        // pointers, which std::hash leaves unchanged, over the table
+        return (uint64_t(hasher(key)) * 0x9e3779b97f4a7c15ULL) >> shift;
+    }
+
+    size_type
+    findSlot(const Key &key) const
+    {
+        if (!_size)
+            return slots.size();
+
+        size_type idx = home(key);
+        for (unsigned dist = 1; dists[idx] >= dist; ++dist) {
+            if (dists[idx] == dist && keyEqual(slots[idx].first, key))
+                return idx;
+            idx = (idx + 1) & mask;
+        }
+        return slots.size();
+    }
+
+    void
+    rehash(size_type capacity)
+    {
+        std::vector<uint8_t> old_dists(capacity, 0);
+        std::vector<value_type> old_slots(capacity);
+        old_dists.swap(dists);
+        old_slots.swap(slots);
+
+        mask = capacity - 1;
+        shift = 64;
+        for (size_type c = capacity; c > 1; c >>= 1)
+            --shift;
+        _size = 0;
+
+        for (size_type i = 0; i < old_slots.size(); ++i) {
+            if (old_dists[i])
+                insertNew(std::move(old_slots[i]));
+        }
+    }
+
+    /**
+     * Insert an entry whose key is known not to be in the map.
+     *
+     * @return The slot the entry ended up in.
+     */
+    size_type
+    insertNew(value_type &&value)
+    {
+        if ((_size + 1) * 4 > slots.size() * 3)
+            rehash(slots.size() * 2);
+
+        size_type pos = slots.size();
+        size_type idx = home(value.first);
+        unsigned dist = 1;
+
+        while (dists[idx]) {
+            if (dist == maxDist) {
+                // pathological clustering, make room and start over
+                // with the entry that is currently displaced
+                const Key key =
+                    pos == slots.size() ? value.first : slots[pos].first;
+                rehash(slots.size() * 2);
+                insertNew(std::move(value));
+                return findSlot(key);
+            }
+            if (dists[idx] < dist) {
+                // take the slot of an entry closer to its home, and
+                // carry on with that entry instead
+                std::swap(value, slots[idx]);
+                uint8_t displaced = dists[idx];
+                dists[idx] = dist;
+                dist = displaced;
+                if (pos == slots.size())
+                    pos = idx;
+            }
+            idx = (idx + 1) & mask;
+            ++dist;
+        }
+
+        slots[idx] = std::move(value);
+        dists[idx] = dist;
+        ++_size;
+        return pos == slots.size() ? idx : pos;
+    }
+
+    void
+    eraseSlot(size_type idx)
+    {
+        size_type next = (idx + 1) & mask;
+        while (dists[next] > 1) {
+            slots[idx] = std::move(slots[next]);
+            dists[idx] = dists[next] - 1;
+            idx = next;
+            next = (next + 1) & mask;
+        }
+        slots[idx] = value_type();
+        dists[idx] = 0;
+        --_size;
+    }
+
+    template <bool Const>
+    class Iter
+    {
+      private:
+        typedef typename std::conditional<Const, const FlatHashMap,
+                                          FlatHashMap>::type Map;
+        Map *map;
+        size_type idx;
+
+        void
+        skipFree()
+        {
+            while (idx < map->slots.size() && !map->dists[idx])
+                ++idx;
+        }
+
+        friend class FlatHashMap;
+        template <bool> friend class Iter;
+
+      public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<Key, T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type *,
+                                          value_type *>::type pointer;
+        typedef typename std::conditional<Const, const value_type &,
+                                          value_type &>::type reference;
+
+        Iter() : map(nullptr), idx(0) {}
+        Iter(Map *_map, size_type _idx) : map(_map), idx(_idx) {}
+
+        /** Allow conversion from iterator to const_iterator. */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false> &other) : map(other.map), idx(other.idx) {}
+
+        reference operator*() const { return map->slots[idx]; }
+        pointer operator->() const { return &map->slots[idx]; }
+
+        Iter &
+        operator++()
+        {
+            ++idx;
+            skipFree();
+            return *this;
+        }
+
+        Iter
+        operator++(int)
+        {
+            Iter it = *this;
+            ++*this;
+            return it;
+        }
+
+        bool
+        operator==(const Iter &other) const
+        {
+            return idx == other.idx;
+        }
+
+        bool
+        operator!=(const Iter &other) const
+        {
+            return idx != other.idx;
+        }
+    };
+
+  public:
+    typedef Iter<false> iterator;
+    typedef Iter<true> const_iterator;
+
+    FlatHashMap() : _size(0) { rehash(minCapacity); }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    iterator
+    begin()
+    {
+        iterator it(this, 0);
+        it.skipFree();
+        return it;
+    }
+
+    const_iterator
+    begin() const
+    {
+        const_iterator it(this, 0);
+        it.skipFree();
+        return it;
+    }
+
+    iterator end() { return iterator(this, slots.size()); }
+    const_iterator end() const { return const_iterator(this, slots.size()); }
+
+    iterator find(const Key &key) { return iterator(this, findSlot(key)); }
+
+    const_iterator
+    find(const Key &key) const
+    {
+        return const_iterator(this, findSlot(key));
+    }
+
+    size_type
+    count(const Key &key) const
+    {
+        return findSlot(key) != slots.size();
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool>
+    emplace(const Key &key, Args&&... args)
+    {
+        size_type idx = findSlot(key);
+        if (idx != slots.size())
+            return std::make_pair(iterator(this, idx), false);
+
+        idx = insertNew(value_type(key, T(std::forward<Args>(args)...)));
+        return std::make_pair(iterator(this, idx), true);
+    }
+
+    T &operator[](const Key &key) { return emplace(key).first->second; }
+
+    void
+    erase(const_iterator it)
+    {
+        assert(it.map == this && it.idx < slots.size() && dists[it.idx]);
+        eraseSlot(it.idx);
+    }
+
+    size_type
+    erase(const Key &key)
+    {
+        size_type idx = findSlot(key);
+        if (idx == slots.size())
+            return 0;
+        eraseSlot(idx);
+        return 1;
+    }
+
+    void
+    clear()
+    {
+        dists.clear();
+        slots.clear();
+        rehash(minCapacity);
+    }
+
+    /** Make room for count entries without growing the table. */
+    void
+    reserve(size_type count)
+    {
+        size_type capacity = slots.size();
+        while (count * 4 > capacity * 3)
+            capacity *= 2;
+        if (capacity != slots.size())
+            rehash(capacity);
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_FLAT_HASH_MAP_HH__
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "base/flat_hash_map.hh"
+#include "base/types.hh"
+
+using namespace gem5;
+
+/** Basic insertion, lookup and erase. */
+TEST(FlatHashMapTest, InsertFindErase)
+{
+    FlatHashMap<Addr, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0x40), map.end());
+
+    auto res = map.emplace(0x40, 1);
+    EXPECT_TRUE(res.second);
+    EXPECT_EQ(res.first->first, 0x40);
+    EXPECT_EQ(res.first->second, 1);
+
+    res = map.emplace(0x40, 2);
+    EXPECT_FALSE(res.second);
+    EXPECT_EQ(res.first->second, 1);
+
+    map[0x80] = 3;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.count(0x80), 1);
+
+    map.erase(map.find(0x40));
+    EXPECT_EQ(map.find(0x40), map.end());
+    EXPECT_EQ(map.erase(0x80), 1);
+    EXPECT_EQ(map.erase(0x80), 0);
+    EXPECT_TRUE(map.empty());
+}
+
+/** A random mix of operations gives the same result as unordered_map. */
+TEST(FlatHashMapTest, MatchesUnorderedMap)
+{
+    FlatHashMap<Addr, uint64_t> map;
+    std::unordered_map<Addr, uint64_t> ref;
+    std::mt19937_64 rng(7);
+
+    for (unsigned i = 0; i < 200000; i++) {
+        // line aligned addresses out of a small range, so that the
+        // mix of hits, misses and erases stays balanced
+        Addr addr = (rng() % 4096) << 6;
+        switch (rng() % 4) {
+          case 0:
+          case 1:
+            map[addr] += i;
+            ref[addr] += i;
+            break;
+          case 2:
+            EXPECT_EQ(map.erase(addr), ref.erase(addr));
+            break;
+          default:
+            auto it = map.find(addr);
+            auto ref_it = ref.find(addr);
+            ASSERT_EQ(it == map.end(), ref_it == ref.end());
+            if (it != map.end()) {
+                EXPECT_EQ(it->second, ref_it->second);
+            }
+        }
+        ASSERT_EQ(map.size(), ref.size());
+    }
+
+    size_t visited = 0;
+    for (const auto &entry : map) {
+        EXPECT_EQ(entry.second, ref.at(entry.first));
+        ++visited;
+    }
+    EXPECT_EQ(visited, ref.size());
+}
+
+/** Keys that hold references are released when erased. */
+TEST(FlatHashMapTest, SharedPtrKeys)
+{
+    FlatHashMap<std::shared_ptr<int>, int> map;
+    auto key = std::make_shared<int>(1);
+    map[key] = 2;
+    EXPECT_EQ(key.use_count(), 2);
+    map.erase(key);
+    EXPECT_EQ(key.use_count(), 1);
+
+    std::vector<std::shared_ptr<int>> keys;
+    for (int i = 0; i < 1000; i++) {
+        keys.push_back(std::make_shared<int>(i));
+        map[keys.back()] = i;
+    }
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(map.find(keys[i])->second, i);
+    map.clear();
+    EXPECT_EQ(keys[0].use_count(), 1);
+}
+
+namespace
+{
+
+/** Lookups and updates per second of a map in a snoop filter pattern. */
+template <typename Map>
+double
+snoopFilterPattern(unsigned lines, unsigned ops)
+{
+    Map map;
+    std::mt19937_64 rng(3);
+    for (unsigned i = 0; i < lines; i++)
+        map[Addr(i) << 6] = i;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (unsigned i = 0; i < ops; i++) {
+        Addr addr = (rng() % (2 * lines)) << 6;
+        auto it = map.find(addr);
+        if (it == map.end()) {
+            map.emplace(addr, i);
+        } else {
+            sum += it->second;
+            map.erase(it);
+        }
+    }
+    std::chrono::duration<double> secs =
+        std::chrono::steady_clock::now() - start;
+    EXPECT_NE(sum, 1);
+    return ops / secs.count();
+}
+
+} // anonymous namespace
+
+/**
+ * Throughput of FlatHashMap and std::unordered_map for working sets
+ * up to the size of a large snoop filter. This is a benchmark rather
+ * than a test; run it with --gtest_also_run_disabled_tests.
+ */
+TEST(FlatHashMapTest, DISABLED_SnoopFilterThroughput)
+{
+    const unsigned ops = 2000000;
+
+    for (unsigned lines : {1024, 65536, 1048576}) {
+        std::cout << "lines " << lines << ": unordered_map "
+                  << snoopFilterPattern<
+                        std::unordered_map<Addr, uint64_t>>(lines, ops)
+                  << " ops/s, flat "
+                  << snoopFilterPattern<
+                        FlatHashMap<Addr, uint64_t>>(lines, ops)
+                  << " ops/s\n";
+    }
+}
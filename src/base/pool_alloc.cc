@@ -0,0 +1,49 @@
+#include "base/pool_alloc.hh"
+
+#include <mutex>
+#include <vector>
+
+namespace gem5
+{
+
+namespace pool_alloc
+{
+
+namespace
+{
+
+std::mutex countsLock;
+
+std::vector<const Counts *> &
+allCounts()
+{
+    static std::vector<const Counts *> counts;
+    return counts;
+}
+
+} // anonymous namespace
+
+void
+registerCounts(const Counts *counts)
+{
+    std::lock_guard<std::mutex> lock(countsLock);
+    allCounts().push_back(counts);
+}
+
+Counts
+totals()
+{
+    std::lock_guard<std::mutex> lock(countsLock);
+
+    // the counts of other threads are read without synchronisation,
+    // which is good enough for statistics
+    Counts sum;
+    for (const Counts *counts : allCounts()) {
+        sum.allocs += counts->allocs;
+        sum.misses += counts->misses;
+    }
+    return sum;
+}
+
+} // namespace pool_alloc
+} // namespace gem5
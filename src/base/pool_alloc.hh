@@ -0,0 +1,163 @@
+/* @file
+ * Per-thread pools of fixed size memory blocks
+ */
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace gem5
+{
+
+namespace pool_alloc
+{
+
+/** Allocation counts of one pool on one host thread. */
+struct Counts
+{
+    /** Blocks handed out by the pool. */
+    uint64_t allocs = 0;
+    /** Allocations the free list could not serve. */
+    uint64_t misses = 0;
+};
+
+/**
+ * Make the counts of a pool visible to totals(). The counts must stay
+ * valid for the rest of the simulation.
+ */
+void registerCounts(const Counts *counts);
+
+/** Sum of the counts of all the pools on all the host threads. */
+Counts totals();
+
+} // namespace pool_alloc
+
+/**
+ * A pool of memory blocks of Size bytes. Released blocks are kept on a
+ * free list per host thread and handed out again by the next
+ * allocation on that thread, without locking or going to the host
+ * allocator. A block may be released by a different thread than the
+ * one that allocated it, it then simply moves to the free list of the
+ * releasing thread.
+ *
+ * The free list of a thread is never torn down, so objects with static
+ * storage that are destroyed after the thread exits can still release
+ * their blocks. Each list holds at most maxFree blocks; beyond that,
+ * blocks go back to the host allocator.
+ */
+template <std::size_t Size>
+class FixedSizePool
+{
+  private:
+    struct Block
+    {
+        Block *next;
+    };
+
+    static_assert(Size >= sizeof(Block), "Pool blocks are too small");
+
+    struct FreeList
+    {
+        Block *head = nullptr;
+        std::size_t length = 0;
+        pool_alloc::Counts counts;
+    };
+
+    static FreeList &
+    freeList()
+    {
+        thread_local FreeList *list = nullptr;
+        if (!list) {
+            list = new FreeList;
+            pool_alloc::registerCounts(&list->counts);
+        }
+        return *list;
+    }
+
+  public:
+    static constexpr std::size_t maxFree = 4096;
+
+    static void *
+    allocate()
+    {
+        FreeList &list = freeList();
+        ++list.counts.allocs;
+
+        Block *block = list.head;
+        if (!block) {
+            ++list.counts.misses;
+            return ::operator new(Size);
+        }
+
+        list.head = block->next;
+        --list.length;
+        return block;
+    }
+
+    static void
+    release(void *ptr)
+    {
+        if (!ptr)
+            return;
+
+        FreeList &list = freeList();
+        if (list.length >= maxFree) {
+            ::operator delete(ptr);
+            return;
+        }
+
+        Block *block = static_cast<Block *>(ptr);
+        block->next = list.head;
+        list.head = block;
+        ++list.length;
+    }
+};
+
+/**
+ * Standard allocator that takes single objects from a FixedSizePool,
+ * for use with std::allocate_shared and node based containers. Arrays
+ * go to the host allocator.
+ */
+template <typename T>
+class PoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Pooled objects cannot be over-aligned");
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n != 1)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(FixedSizePool<sizeof(T)>::allocate());
+    }
+
+    void
+    deallocate(T *ptr, std::size_t n)
+    {
+        if (n != 1)
+            ::operator delete(ptr);
+        else
+            FixedSizePool<sizeof(T)>::release(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOC_HH__
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "base/pool_alloc.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct Payload
+{
+    uint64_t words[6];
+};
+
+} // anonymous namespace
+
+/** A released block is handed out again by the next allocation. */
+TEST(PoolAllocTest, ReusesReleasedBlocks)
+{
+    void *first = FixedSizePool<48>::allocate();
+    FixedSizePool<48>::release(first);
+    void *second = FixedSizePool<48>::allocate();
+    EXPECT_EQ(first, second);
+    FixedSizePool<48>::release(second);
+}
+
+/** Allocations are counted, and misses only when the list is empty. */
+TEST(PoolAllocTest, CountsAllocations)
+{
+    // warm the free list up
+    FixedSizePool<40>::release(FixedSizePool<40>::allocate());
+
+    pool_alloc::Counts before = pool_alloc::totals();
+    for (int i = 0; i < 10; i++)
+        FixedSizePool<40>::release(FixedSizePool<40>::allocate());
+    pool_alloc::Counts after = pool_alloc::totals();
+
+    EXPECT_EQ(after.allocs - before.allocs, 10);
+    EXPECT_EQ(after.misses, before.misses);
+}
+
+/** Blocks released on another thread end up on that thread's list. */
+TEST(PoolAllocTest, ReleaseOnOtherThread)
+{
+    std::vector<void *> blocks;
+    for (int i = 0; i < 100; i++)
+        blocks.push_back(FixedSizePool<56>::allocate());
+
+    std::thread other([&blocks] {
+        for (void *block : blocks)
+            FixedSizePool<56>::release(block);
+        // the blocks are now local to this thread
+        void *block = FixedSizePool<56>::allocate();
+        EXPECT_EQ(block, blocks.back());
+        FixedSizePool<56>::release(block);
+    });
+    other.join();
+}
+
+/** The allocator works with shared pointers. */
+TEST(PoolAllocTest, SharedPtr)
+{
+    auto ptr = std::allocate_shared<Payload>(PoolAllocator<Payload>());
+    ptr->words[5] = 42;
+    std::weak_ptr<Payload> weak = ptr;
+    EXPECT_EQ(weak.lock()->words[5], 42);
+    ptr.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+/**
+ * Shared pointers per second created through the host allocator and
+ * through the pool. This is a benchmark rather than a test; run it
+ * with --gtest_also_run_disabled_tests.
+ */
+TEST(PoolAllocTest, DISABLED_SharedPtrThroughput)
+{
+    const unsigned num_ptrs = 10000000;
+    const unsigned in_flight = 64;
+
+    for (bool pooled : {false, true}) {
+        std::vector<std::shared_ptr<Payload>> ptrs(in_flight);
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < num_ptrs; i++) {
+            ptrs[i % in_flight] = pooled ?
+                std::allocate_shared<Payload>(PoolAllocator<Payload>()) :
+                std::make_shared<Payload>();
+        }
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+
+        std::cout << (pooled ? "pool  " : "malloc") << ": "
+                  << num_ptrs / secs.count() << " allocations/s\n";
+    }
+}
@@ -107,6 +107,12 @@ class InfoProxy : public Base
     void prepare() { s.prepare(); }
     void reset() { s.reset(); }
     void
+    disable()
+    {
+        Base::disable();
+        s.disable();
+    }
+    void
     visit(Output &visitor)
     {
         visitor.visit(*static_cast<Base *>(this));
@@ -209,6 +215,11 @@ class InfoAccess
      */
     void reset() { }
 
+    /**
+     * Stop collecting the stat, for stats whose updates are costly.
+     */
+    void disable() { }
+
     /**
      * @return true if this stat has a value and satisfies its
      * requirement as a prereq
@@ -1281,6 +1292,9 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
     /** The storage for this stat. */
     GEM5_ALIGNED(8) char storage[sizeof(Storage)];
 
+    /** Whether samples are added, false if the stat was filtered out. */
+    bool collecting = true;
+
   protected:
     /**
      * Retrieve the storage.
@@ -1324,7 +1338,15 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        if (GEM5_LIKELY(collecting))
+            data()->sample(v, n);
+    }
+
+    /** Stop adding samples. */
+    void disable() { collecting = false; }
 
     /**
      * Return the number of entries in this stat.
@@ -1376,6 +1398,9 @@ class VectorDistBase : public DataWrapVec<Derived, VectorDistInfoProxy>
   protected:
     std::vector<Storage*> storage;
 
+    /** Whether samples are added, false if the stat was filtered out. */
+    bool collecting = true;
+
   protected:
     Storage *
     data(off_type index)
@@ -1423,6 +1448,9 @@ class VectorDistBase : public DataWrapVec<Derived, VectorDistInfoProxy>
         return Proxy(this->self(), index);
     }
 
+    /** Stop adding samples. */
+    void disable() { collecting = false; }
+
     size_type
     size() const
     {
@@ -1488,7 +1516,8 @@ class DistProxy
     void
     sample(const U &v, int n = 1)
     {
-        data()->sample(v, n);
+        if (GEM5_LIKELY(stat.collecting))
+            data()->sample(v, n);
     }
 
     size_type
@@ -2418,6 +2447,9 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
     /** The storage for this stat. */
     char storage[sizeof(Storage)];
 
+    /** Whether samples are added, false if the stat was filtered out. */
+    bool collecting = true;
+
   protected:
     /**
      * Retrieve the storage.
@@ -2461,7 +2493,15 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        if (GEM5_LIKELY(collecting))
+            data()->sample(v, n);
+    }
+
+    /** Stop adding samples. */
+    void disable() { collecting = false; }
 
     /**
      * Return the number of entries in this stat.
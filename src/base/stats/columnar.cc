@@ -0,0 +1,282 @@
+#include "base/stats/columnar.hh"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+#include "sim/byteswap.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+namespace
+{
+
+const char magic[8] = {'g', 'e', 'm', '5', 'c', 'o', 'l', '\0'};
+const uint32_t version = 1;
+
+template <typename T>
+void
+writeValue(std::ostream &os, T value)
+{
+    value = htole(value);
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+/** The bits of a double, in little endian byte order. */
+uint64_t
+doubleToLE(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return htole(bits);
+}
+
+void
+writeString(std::ostream &os, const std::string &str)
+{
+    writeValue<uint32_t>(os, str.size());
+    os.write(str.data(), str.size());
+}
+
+std::string
+subname(const std::vector<std::string> &subnames, off_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    return std::to_string(i);
+}
+
+} // anonymous namespace
+
+Columnar::Columnar(const std::string &file)
+    : stream(simout.create(file, true)), firstDump(true)
+{
+    fatal_if(!valid(), "Unable to open statistics file '%s' for writing\n",
+             file);
+}
+
+Columnar::~Columnar()
+{
+    simout.close(stream);
+}
+
+bool
+Columnar::valid() const
+{
+    return stream && stream->stream()->good();
+}
+
+void
+Columnar::begin()
+{
+    row.clear();
+}
+
+void
+Columnar::end()
+{
+    std::ostream &os = *stream->stream();
+    if (firstDump) {
+        writeSchema();
+        firstDump = false;
+    } else if (row.size() != names.size()) {
+        warn_once("Skipped stat dumps that do not match the columns of "
+                  "the first dump in %s\n", stream->name());
+        return;
+    }
+
+    writeValue<uint64_t>(os, curTick());
+    leRow.resize(row.size());
+    for (size_t i = 0; i < row.size(); i++)
+        leRow[i] = doubleToLE(row[i]);
+    os.write(reinterpret_cast<const char *>(leRow.data()),
+             leRow.size() * sizeof(uint64_t));
+    os.flush();
+}
+
+void
+Columnar::writeSchema()
+{
+    std::ostream &os = *stream->stream();
+    os.write(magic, sizeof(magic));
+    writeValue<uint32_t>(os, version);
+    writeValue<uint32_t>(os, names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        writeString(os, names[i]);
+        writeString(os, units[i]);
+    }
+}
+
+std::string
+Columnar::statName(const std::string &name) const
+{
+    return path.empty() ? name : path.top() + "." + name;
+}
+
+void
+Columnar::beginGroup(const char *name)
+{
+    if (firstDump)
+        path.push(statName(name));
+}
+
+void
+Columnar::endGroup()
+{
+    if (firstDump)
+        path.pop();
+}
+
+void
+Columnar::addColumn(const Info &info, const std::string &suffix)
+{
+    names.push_back(suffix.empty() ? statName(info.name) :
+                    statName(info.name) + info.separatorString + suffix);
+    units.push_back(info.unit->getUnitString());
+}
+
+void
+Columnar::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    if (firstDump)
+        addColumn(info, "");
+    row.push_back(info.result());
+}
+
+void
+Columnar::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &vec = info.result();
+    const size_type size = vec.size();
+    for (off_type i = 0; i < size; ++i) {
+        if (firstDump)
+            addColumn(info, size == 1 ? "" : subname(info.subnames, i));
+        row.push_back(vec[i]);
+    }
+
+    if (info.flags.isSet(total) && size > 1) {
+        if (firstDump)
+            addColumn(info, "total");
+        row.push_back(info.total());
+    }
+}
+
+void
+Columnar::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    for (off_type i = 0; i < info.x; ++i) {
+        for (off_type j = 0; j < info.y; ++j) {
+            if (firstDump) {
+                addColumn(info, subname(info.subnames, i) +
+                          info.separatorString +
+                          subname(info.y_subnames, j));
+            }
+            row.push_back(info.cvec[i * info.y + j]);
+        }
+    }
+
+    if (info.flags.isSet(total)) {
+        if (firstDump)
+            addColumn(info, "total");
+        row.push_back(info.total());
+    }
+}
+
+void
+Columnar::appendDist(const Info &info, const std::string &prefix,
+                     const DistData &data)
+{
+    const Result samples = data.samples;
+    const Result nan = std::nan("");
+
+    auto append = [&](const char *name, Result value) {
+        if (firstDump)
+            addColumn(info, prefix + name);
+        row.push_back(value);
+    };
+
+    append("samples", samples);
+    append("mean", samples ? data.sum / samples : nan);
+    if (data.type == Hist)
+        append("gmean", samples ? std::exp(data.logs / samples) : nan);
+    append("stdev", samples ? std::sqrt((samples * data.squares -
+                                         data.sum * data.sum) /
+                                        (samples * (samples - 1.0))) : nan);
+    if (data.type == Deviation)
+        return;
+
+    // histograms grow their buckets, so buckets are named by index, and
+    // the bucket layout of each dump is part of the row
+    append("min_bucket", data.min);
+    append("bucket_size", data.bucket_size);
+    if (data.type == Dist)
+        append("underflows", data.underflow);
+    for (off_type i = 0; i < data.cvec.size(); ++i) {
+        if (firstDump)
+            addColumn(info, prefix + std::to_string(i));
+        row.push_back(data.cvec[i]);
+    }
+    if (data.type == Dist) {
+        append("overflows", data.overflow);
+        append("min_value", data.min_val);
+        append("max_value", data.max_val);
+    }
+}
+
+void
+Columnar::visit(const DistInfo &info)
+{
+    if (info.flags.isSet(display))
+        appendDist(info, "", info.data);
+}
+
+void
+Columnar::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    for (off_type i = 0; i < info.size(); ++i) {
+        appendDist(info, firstDump ?
+                   subname(info.subnames, i) + info.separatorString : "",
+                   info.data[i]);
+    }
+}
+
+void
+Columnar::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Columnar::visit(const SparseHistInfo &info)
+{
+    // sparse histograms have no fixed size, so they have no columns
+}
+
+std::unique_ptr<Output>
+initColumnar(const std::string &filename)
+{
+    return std::make_unique<Columnar>(filename);
+}
+
+} // namespace statistics
+} // namespace gem5
@@ -0,0 +1,116 @@
+/* @file
+ * Columnar time series of periodic stat dumps
+ */
+
+#ifndef __BASE_STATS_COLUMNAR_HH__
+#define __BASE_STATS_COLUMNAR_HH__
+
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/output.hh"
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Writes each stat dump as one fixed width row of a table whose columns
+ * are the stats. The names and units of the columns are only written
+ * once, with the first dump, so frequent dumps stay cheap to write and
+ * small to store. The file is gzip compressed if its name ends in .gz.
+ *
+ * The file starts with the magic "gem5col\0", then holds the version,
+ * the number of columns and, for each column, its name and its unit as
+ * strings prefixed with their length. Each row is the tick of the dump,
+ * followed by the value of each column. All integers are unsigned, 32
+ * bits wide (64 bits for the tick), values are doubles, and both are
+ * little endian, whatever the byte order of the host.
+ *
+ * Every dump must visit the same stats as the first. Each vector,
+ * distribution and formula takes one column per element, regardless of
+ * the nozero, nonan and prereq settings of the stat, and sparse
+ * histograms, which do not have a fixed size, are left out.
+ */
+class Columnar : public Output
+{
+  public:
+    Columnar(const std::string &file);
+
+    ~Columnar();
+
+    Columnar() = delete;
+    Columnar(const Columnar &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /**
+     * Add a column to the schema, which is only done during the first
+     * dump.
+     *
+     * @param info Stat the column belongs to.
+     * @param suffix Suffix of the column name, after the stat name.
+     */
+    void addColumn(const Info &info, const std::string &suffix);
+
+    /**
+     * Append the columns of one distribution to the current row.
+     *
+     * @param info Stat the distribution belongs to.
+     * @param prefix Prefix of the column suffixes, only used during the
+     *               first dump.
+     * @param data Data of the distribution.
+     */
+    void appendDist(const Info &info, const std::string &prefix,
+                    const DistData &data);
+
+    std::string statName(const std::string &name) const;
+
+    void writeSchema();
+
+  protected:
+    OutputStream *stream;
+
+    /** Group path, only kept while the schema is being built. */
+    std::stack<std::string> path;
+
+    /** The schema is built from the stats of the first dump. */
+    bool firstDump;
+
+    std::vector<std::string> names;
+    std::vector<std::string> units;
+
+    /** Values of the current row. */
+    std::vector<double> row;
+
+    /** The current row as written, reused across dumps. */
+    std::vector<uint64_t> leRow;
+};
+
+std::unique_ptr<Output> initColumnar(const std::string &filename);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_COLUMNAR_HH__
@@ -0,0 +1,238 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "base/stats/columnar.hh"
+#include "base/stats/info.hh"
+#include "sim/byteswap.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class TestScalar : public statistics::ScalarInfo
+{
+  public:
+    statistics::Result val = 0;
+
+    TestScalar(const std::string &_name)
+    {
+        name = _name;
+        flags.set(statistics::display);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return val == 0; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+
+    statistics::Counter value() const override { return val; }
+    statistics::Result result() const override { return val; }
+    statistics::Result total() const override { return val; }
+};
+
+class TestVector : public statistics::VectorInfo
+{
+  public:
+    statistics::VResult vec;
+
+    TestVector(const std::string &_name, size_t size) : vec(size)
+    {
+        name = _name;
+        flags.set(statistics::display);
+    }
+
+    bool check() const override { return true; }
+    void prepare() override {}
+    void reset() override {}
+    bool zero() const override { return false; }
+    void visit(statistics::Output &visitor) override { visitor.visit(*this); }
+
+    statistics::size_type size() const override { return vec.size(); }
+    const statistics::VCounter &value() const override { return vec; }
+    const statistics::VResult &result() const override { return vec; }
+
+    statistics::Result
+    total() const override
+    {
+        statistics::Result sum = 0;
+        for (auto v : vec)
+            sum += v;
+        return sum;
+    }
+};
+
+/** Reads back the file the way the Python reader does. */
+struct ColumnarFile
+{
+    std::vector<std::string> names;
+    std::vector<std::string> units;
+    std::vector<uint64_t> ticks;
+    std::vector<std::vector<double>> rows;
+
+    ColumnarFile(const std::string &path)
+    {
+        std::ifstream is(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(is)),
+                         std::istreambuf_iterator<char>());
+        size_t pos = 0;
+        auto take = [&](void *dst, size_t bytes) {
+            EXPECT_LE(pos + bytes, data.size());
+            std::memcpy(dst, data.data() + pos, bytes);
+            pos += bytes;
+        };
+        auto take_le = [&](auto &value) {
+            take(&value, sizeof(value));
+            value = letoh(value);
+        };
+        auto take_string = [&]() {
+            uint32_t size;
+            take_le(size);
+            std::string str = data.substr(pos, size);
+            pos += size;
+            return str;
+        };
+
+        char magic[8];
+        uint32_t version, columns;
+        take(magic, sizeof(magic));
+        EXPECT_EQ(0, std::memcmp(magic, "gem5col", 8));
+        take_le(version);
+        EXPECT_EQ(1, version);
+        take_le(columns);
+        for (uint32_t c = 0; c < columns; c++) {
+            names.push_back(take_string());
+            units.push_back(take_string());
+        }
+
+        while (pos < data.size()) {
+            uint64_t tick;
+            take_le(tick);
+            ticks.push_back(tick);
+            rows.emplace_back(columns);
+            for (double &value : rows.back()) {
+                uint64_t bits;
+                take_le(bits);
+                std::memcpy(&value, &bits, sizeof(value));
+            }
+        }
+    }
+};
+
+} // anonymous namespace
+
+class StatsColumnarTest : public ::testing::Test
+{
+  protected:
+    Tick tick = 0;
+    std::string path = "columnar.test.stats";
+
+    void SetUp() override { Gem5Internal::_curTickPtr = &tick; }
+    void TearDown() override { unlink(path.c_str()); }
+};
+
+/** The schema is written once, and every dump adds a row. */
+TEST_F(StatsColumnarTest, Rows)
+{
+    TestScalar scalar("scalar");
+    TestVector vector("vector", 2);
+    vector.flags.set(statistics::total);
+    vector.subnames = {"a", ""};
+
+    {
+        statistics::Columnar output(path);
+        for (int dump = 0; dump < 3; dump++) {
+            tick = 1000 * dump;
+            scalar.val = dump;
+            vector.vec = {10.0 + dump, 20.0 + dump};
+
+            output.begin();
+            scalar.visit(output);
+            output.beginGroup("group");
+            vector.visit(output);
+            output.endGroup();
+            output.end();
+        }
+    }
+
+    ColumnarFile file(path);
+    ASSERT_EQ(4, file.names.size());
+    EXPECT_EQ("scalar", file.names[0]);
+    EXPECT_EQ("group.vector::a", file.names[1]);
+    EXPECT_EQ("group.vector::1", file.names[2]);
+    EXPECT_EQ("group.vector::total", file.names[3]);
+
+    ASSERT_EQ(3, file.rows.size());
+    for (int dump = 0; dump < 3; dump++) {
+        EXPECT_EQ(1000 * dump, file.ticks[dump]);
+        EXPECT_EQ(dump, file.rows[dump][0]);
+        EXPECT_EQ(10.0 + dump, file.rows[dump][1]);
+        EXPECT_EQ(20.0 + dump, file.rows[dump][2]);
+        EXPECT_EQ(30.0 + 2 * dump, file.rows[dump][3]);
+    }
+}
+
+/** Stats that are not displayed, or zero, still keep their columns. */
+TEST_F(StatsColumnarTest, FixedColumns)
+{
+    TestScalar shown("shown");
+    TestScalar hidden("hidden");
+    hidden.flags.clear(statistics::display);
+    shown.flags.set(statistics::nozero);
+
+    {
+        statistics::Columnar output(path);
+        for (int dump = 0; dump < 2; dump++) {
+            shown.val = dump;
+            output.begin();
+            shown.visit(output);
+            hidden.visit(output);
+            output.end();
+        }
+    }
+
+    ColumnarFile file(path);
+    ASSERT_EQ(1, file.names.size());
+    EXPECT_EQ("shown", file.names[0]);
+    ASSERT_EQ(2, file.rows.size());
+    EXPECT_EQ(0, file.rows[0][0]);
+    EXPECT_EQ(1, file.rows[1][0]);
+}
+
+/** Numbers are little endian, whatever the host byte order. */
+TEST_F(StatsColumnarTest, LittleEndian)
+{
+    TestScalar scalar("s");
+
+    {
+        statistics::Columnar output(path);
+        tick = 0x0102;
+        scalar.val = 1.0;
+        output.begin();
+        scalar.visit(output);
+        output.end();
+    }
+
+    std::ifstream is(path, std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(is)),
+                              std::istreambuf_iterator<char>());
+    // after the magic: the version, the number of columns and the name
+    const std::vector<uint8_t> expected = {
+        1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 's'};
+    ASSERT_GE(data.size(), 8 + expected.size() + 4 + 16);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+                           data.begin() + 8));
+    // the tick, then 1.0 as the IEEE 754 bits 0x3ff0000000000000
+    const std::vector<uint8_t> row = {
+        0x02, 0x01, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xf0, 0x3f};
+    EXPECT_TRUE(std::equal(row.begin(), row.end(), data.end() - 16));
+}
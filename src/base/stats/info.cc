@@ -193,6 +193,12 @@ Info::enable()
 {
 }
 
+void
+Info::disable()
+{
+    flags.clear(display);
+}
+
 void
 VectorInfo::enable()
 {
@@ -140,6 +140,12 @@ class Info
      */
     virtual void enable();
 
+    /**
+     * Stop printing the stat, and stop collecting it where its updates
+     * are costly.
+     */
+    virtual void disable();
+
     /**
      * Prepare the stat for dumping.
      */
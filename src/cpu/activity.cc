@@ -104,6 +104,16 @@ ActivityRecorder::activateStage(const int idx)
 //    assert(activityCount < longestLatency + numStages + 1);
 }
 
+bool
+ActivityRecorder::recentActivity() const
+{
+    int active_stages = 0;
+    for (int i = 0; i < numStages; ++i)
+        active_stages += stageActive[i];
+
+    return activityCount > active_stages;
+}
+
 void
 ActivityRecorder::deactivateStage(const int idx)
 {
@@ -90,6 +90,12 @@ class ActivityRecorder
     /** Returns if the CPU should be active. */
     bool active() { return activityCount; }
 
+    /** Returns if any time buffer was written within the last
+     * longestLatency cycles, ignoring the stages that are merely
+     * marked as active.
+     */
+    bool recentActivity() const;
+
     /** Clears the time buffer and the activity count. */
     void reset();
 
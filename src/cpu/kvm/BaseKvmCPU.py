@@ -51,6 +51,11 @@ class BaseKvmCPU(BaseCPU):
         """Dump the internal state of KVM to standard out."""
         pass
 
+    @cxxMethod
+    def warmCaches(self):
+        """Warm the caches with the guest pages written recently."""
+        pass
+
     @classmethod
     def memory_mode(cls):
         return "atomic_noncaching"
@@ -48,3 +48,12 @@ class KvmVM(SimObject):
     )
 
     system = Param.System(Parent.any, "system this VM belongs to")
+
+    dirty_log_pages = Param.Unsigned(
+        0,
+        "Number of recently written guest pages to track, which the caches "
+        "are warmed with when switching away from KVM (0 to disable)",
+    )
+    dirty_log_period = Param.Latency(
+        "1ms", "Period at which written guest pages are fetched from KVM"
+    )
@@ -598,6 +598,40 @@ BaseKvmCPU::dump() const
     inform("State dumping not implemented.");
 }
 
+void
+BaseKvmCPU::warmCaches()
+{
+    fatal_if(!system->isAtomicMode(),
+             "%s: Caches can only be warmed in atomic mode\n", name());
+
+    // include the pages written since the last periodic update
+    vm->updateDirtyLog();
+    const std::vector<Addr> pages(vm->recentDirtyPages());
+    const unsigned line_size = system->cacheLineSize();
+    std::vector<uint8_t> line(line_size);
+
+    size_t warmed = 0;
+    for (size_t i = pages.size(); i-- > 0; ) {
+        if (i % vm->nextVCPUID != vcpuID)
+            continue;
+
+        for (Addr addr = pages[i]; addr < pages[i] + pageSize;
+             addr += line_size) {
+            // the memory is up to date, as KVM bypasses the caches, so
+            // read the line in clean rather than writing it back dirty
+            auto req = std::make_shared<Request>(
+                addr, line_size, 0, dataRequestorId());
+            Packet read(req, MemCmd::ReadReq);
+            read.dataStatic(line.data());
+            dataPort.sendAtomic(&read);
+        }
+        ++warmed;
+    }
+
+    DPRINTF(Kvm, "Warmed the caches with %i of %i recently written pages\n",
+            warmed, pages.size());
+}
+
 void
 BaseKvmCPU::tick()
 {
@@ -658,6 +692,8 @@ BaseKvmCPU::tick()
           // dirty with respect to the cached thread context.
           kvmStateDirty = true;
 
+          vm->updateDirtyLog();
+
           if (alwaysSyncTC)
               syncThreadContext();
 
@@ -129,6 +129,16 @@ class BaseKvmCPU : public BaseCPU
     /** Dump the internal state to the terminal. */
     virtual void dump() const;
 
+    /**
+     * Warm the caches with the guest pages written recently, as logged by
+     * the VM, before switching to a CPU model that uses the caches. The
+     * pages are spread over the vCPUs of the VM, and each vCPU reads its
+     * share of the pages through its data port, oldest page first, so
+     * the lines are installed clean. This must be called on a drained
+     * system in atomic mode.
+     */
+    void warmCaches();
+
     /**
      * Force an exit from KVM.
      *
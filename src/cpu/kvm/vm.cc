@@ -48,6 +48,8 @@
 #include <cerrno>
 #include <memory>
 
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "cpu/kvm/base.hh"
 #include "debug/Kvm.hh"
 #include "mem/physical.hh"
@@ -319,7 +321,10 @@ KvmVM::KvmVM(const KvmVMParams &params)
       vmFD(kvm->createVM()),
       started(false),
       _hasKernelIRQChip(false),
-      nextVCPUID(0)
+      nextVCPUID(0),
+      dirtyLogPages(params.dirty_log_pages),
+      dirtyLogPeriod(params.dirty_log_period),
+      nextDirtyLog(0)
 {
     system->setKvmVM(this);
     maxMemorySlot = kvm->capNumMemSlots();
@@ -390,7 +395,8 @@ KvmVM::delayedStartup()
             }
 
             const MemSlot slot = allocMemSlot(range.size());
-            setupMemSlot(slot, pmem, range.start(), 0/* flags */);
+            setupMemSlot(slot, pmem, range.start(),
+                         dirtyLogPages ? KVM_MEM_LOG_DIRTY_PAGES : 0);
         } else {
             DPRINTF(Kvm, "Zero-region not mapped: [0x%llx]\n", range.start());
             hack("KVM: Zero memory handled as IO\n");
@@ -421,6 +427,8 @@ KvmVM::allocMemSlot(uint64_t size)
     slot.size = size;
     slot.slot = nextSlot;
     slot.active = false;
+    slot.guest = 0;
+    slot.dirtyLog = false;
 
     memorySlots.push_back(slot);
     return MemSlot(slot.slot);
@@ -432,6 +440,8 @@ KvmVM::setupMemSlot(const KvmVM::MemSlot num, void *host_addr, Addr guest,
 {
     MemorySlot &slot = memorySlots.at(num.num);
     slot.active = true;
+    slot.guest = guest;
+    slot.dirtyLog = flags & KVM_MEM_LOG_DIRTY_PAGES;
     setUserMemoryRegion(num.num, host_addr, guest, slot.size, flags);
 }
 
@@ -452,6 +462,65 @@ KvmVM::freeMemSlot(const KvmVM::MemSlot num)
     slot.size = 0;
 }
 
+void
+KvmVM::updateDirtyLog()
+{
+    if (!dirtyLogPages)
+        return;
+
+    std::lock_guard<std::mutex> lock(dirtyLogLock);
+    if (curTick() < nextDirtyLog)
+        return;
+    nextDirtyLog = curTick() + dirtyLogPeriod;
+
+    // KVM logs writes with one bit per host page
+    const Addr page_size = sysconf(_SC_PAGE_SIZE);
+    std::vector<uint64_t> bitmap;
+    for (const MemorySlot &slot : memorySlots) {
+        if (!slot.active || !slot.dirtyLog)
+            continue;
+
+        bitmap.assign(divCeil(divCeil(slot.size, page_size), 64), 0);
+        struct kvm_dirty_log log;
+        memset(&log, 0, sizeof(log));
+        log.slot = slot.slot;
+        log.dirty_bitmap = bitmap.data();
+        if (ioctl(KVM_GET_DIRTY_LOG, (void *)&log) == -1)
+            panic("KVM: Failed to get the dirty log of slot %i\n", slot.slot);
+
+        for (size_t word = 0; word < bitmap.size(); ++word) {
+            for (uint64_t bits = bitmap[word]; bits; bits &= bits - 1) {
+                touchDirtyPage(slot.guest +
+                               (word * 64 + ctz64(bits)) * page_size);
+            }
+        }
+    }
+}
+
+void
+KvmVM::touchDirtyPage(Addr page)
+{
+    auto it = dirtyPageIndex.find(page);
+    if (it != dirtyPageIndex.end()) {
+        dirtyPages.splice(dirtyPages.begin(), dirtyPages, it->second);
+        return;
+    }
+
+    dirtyPages.push_front(page);
+    dirtyPageIndex[page] = dirtyPages.begin();
+    if (dirtyPages.size() > dirtyLogPages) {
+        dirtyPageIndex.erase(dirtyPages.back());
+        dirtyPages.pop_back();
+    }
+}
+
+std::vector<Addr>
+KvmVM::recentDirtyPages()
+{
+    std::lock_guard<std::mutex> lock(dirtyLogLock);
+    return std::vector<Addr>(dirtyPages.begin(), dirtyPages.end());
+}
+
 void
 KvmVM::setUserMemoryRegion(uint32_t slot,
                            void *host_addr, Addr guest_addr,
@@ -39,6 +39,9 @@
 #ifndef __CPU_KVM_KVMVM_HH__
 #define __CPU_KVM_KVMVM_HH__
 
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "base/addr_range.hh"
@@ -308,6 +311,20 @@ class KvmVM : public SimObject
 
     void notifyFork();
 
+    /**
+     * Fetch the guest pages written since the last call from KVM, and
+     * make them the most recently written pages. This does nothing
+     * unless dirty page logging is enabled, or if the last call was less
+     * than a dirty log period ago. It may be called from any vCPU thread.
+     */
+    void updateDirtyLog();
+
+    /**
+     * Get the guest pages written recently, most recent first, which are
+     * the pages the caches are warmed with.
+     */
+    std::vector<Addr> recentDirtyPages();
+
     /**
      * Setup a shared three-page memory region used by the internals
      * of KVM. This is currently only needed by x86 implementations.
@@ -554,9 +571,28 @@ class KvmVM : public SimObject
         uint64_t size;
         uint32_t slot;
         bool active;
+        /** Guest address of an active slot. */
+        Addr guest;
+        /** Does KVM log the pages written in this slot? */
+        bool dirtyLog;
     };
     std::vector<MemorySlot> memorySlots;
     uint32_t maxMemorySlot;
+
+    /** Make a guest page the most recently written one. */
+    void touchDirtyPage(Addr page);
+
+    /** Maximum number of recently written pages tracked. */
+    const unsigned dirtyLogPages;
+    const Tick dirtyLogPeriod;
+    Tick nextDirtyLog;
+
+    /** Protects the dirty log, which every vCPU thread may update. */
+    std::mutex dirtyLogLock;
+
+    /** Recently written pages, most recent first. */
+    std::list<Addr> dirtyPages;
+    std::unordered_map<Addr, std::list<Addr>::iterator> dirtyPageIndex;
 };
 
 } // namespace gem5
@@ -76,6 +76,11 @@ class BaseO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    skip_stalled_cycles = Param.Bool(
+        False,
+        "Stop ticking while every thread is waiting on a memory access "
+        "at the head of the ROB, and resume when the access completes",
+    )
 
     cacheStorePorts = Param.Unsigned(
         4, "Cache Ports. Constrains stores only."
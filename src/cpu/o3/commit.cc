@@ -383,6 +383,21 @@ Commit::executingHtmTransaction(ThreadID tid) const
         return (htmStarts[tid] > htmStops[tid]);
 }
 
+bool
+Commit::stalledOnMemory(ThreadID tid) const
+{
+    if (commitStatus[tid] != Running || trapSquash[tid] || tcSquash[tid] ||
+        trapInFlight[tid] || interrupt != NoFault ||
+        cpu->checkInterrupts(0) || rob->isEmpty(tid)) {
+        return false;
+    }
+
+    const DynInstPtr &head_inst = rob->readHeadInst(tid);
+    return head_inst->isMemRef() && head_inst->isIssued() &&
+        !head_inst->readyToCommit() && !head_inst->isSquashed() &&
+        !head_inst->isTranslationDelayed();
+}
+
 void
 Commit::resetHtmStartsStops(ThreadID tid)
 {
@@ -199,6 +199,12 @@ class Commit
     /** Is the CPU currently processing a HTM transaction? */
     bool executingHtmTransaction(ThreadID) const;
 
+    /**
+     * Is the thread unable to commit until the memory access of the
+     * instruction at the head of the ROB completes?
+     */
+    bool stalledOnMemory(ThreadID tid) const;
+
     /* Reset HTM tracking, e.g. after an abort */
     void resetHtmStartsStops(ThreadID);
 
@@ -114,6 +114,8 @@ CPU::CPU(const BaseO3CPUParams &params)
       globalSeqNum(1),
       system(params.system),
       lastRunningCycle(curCycle()),
+      skipStalledCycles(params.skip_stalled_cycles),
+      memStalled(false),
       cpuStats(this)
 {
     fatal_if(FullSystem && params.numThreads > 1,
@@ -328,7 +330,13 @@ CPU::CPUStats::CPUStats(CPU *cpu)
                "to idling"),
       ADD_STAT(quiesceCycles, statistics::units::Cycle::get(),
                "Total number of cycles that CPU has spent quiesced or waiting "
-               "for an interrupt")
+               "for an interrupt"),
+      ADD_STAT(stallSkips, statistics::units::Count::get(),
+               "Number of times that the CPU stopped ticking while stalled "
+               "on memory"),
+      ADD_STAT(stallSkippedCycles, statistics::units::Cycle::get(),
+               "Total number of cycles that the CPU skipped while stalled on "
+               "memory")
 {
     // Register any of the O3CPU's stats here.
     timesIdled
@@ -339,6 +347,12 @@ CPU::CPUStats::CPUStats(CPU *cpu)
 
     quiesceCycles
         .prereq(quiesceCycles);
+
+    stallSkips
+        .prereq(stallSkips);
+
+    stallSkippedCycles
+        .prereq(stallSkippedCycles);
 }
 
 void
@@ -351,6 +365,8 @@ CPU::tick()
     ++baseStats.numCycles;
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
+    memStalled = false;
+
 //    activity = false;
 
     //Tick each of the stages
@@ -387,6 +403,11 @@ CPU::tick()
             DPRINTF(O3CPU, "Idle!\n");
             lastRunningCycle = curCycle();
             cpuStats.timesIdled++;
+        } else if (skipStalledCycles && stalledOnMemory()) {
+            DPRINTF(O3CPU, "Stalled on memory!\n");
+            lastRunningCycle = curCycle();
+            memStalled = true;
+            cpuStats.stallSkips++;
         } else {
             schedule(tickEvent, clockEdge(Cycles(1)));
             DPRINTF(O3CPU, "Scheduling next tick!\n");
@@ -399,6 +420,30 @@ CPU::tick()
     tryDrain();
 }
 
+bool
+CPU::stalledOnMemory()
+{
+    // Anything written to a time buffer or waiting to issue or write
+    // back means that the pipeline will still change without outside
+    // help. A younger memory instruction deferred on its translation or
+    // blocked by the cache has to issue while the head waits, so its
+    // access overlaps with the one the head waits for.
+    if (activityRec.recentActivity() || iew.instQueue.hasReadyInsts() ||
+        iew.instQueue.hasDeferredMemInsts() || iew.ldstQueue.willWB()) {
+        return false;
+    }
+
+    // Every event that can unblock a thread from here on, a memory
+    // response, a cache retry, a data translation, an instruction cache
+    // or ITLB completion or an interrupt, calls wakeCPU().
+    for (ThreadID tid : activeThreads) {
+        if (!commit.stalledOnMemory(tid) || !fetch.stalled(tid))
+            return false;
+    }
+
+    return !activeThreads.empty();
+}
+
 void
 CPU::init()
 {
@@ -1297,7 +1342,7 @@ CPU::wakeDependents(const DynInstPtr &inst)
 void
 CPU::wakeCPU()
 {
-    if (activityRec.active() || tickEvent.scheduled()) {
+    if ((activityRec.active() && !memStalled) || tickEvent.scheduled()) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
     }
@@ -1308,16 +1353,27 @@ CPU::wakeCPU()
     // @todo: This is an oddity that is only here to match the stats
     if (cycles > 1) {
         --cycles;
-        cpuStats.idleCycles += cycles;
+        if (memStalled)
+            cpuStats.stallSkippedCycles += cycles;
+        else
+            cpuStats.idleCycles += cycles;
         baseStats.numCycles += cycles;
     }
 
-    schedule(tickEvent, clockEdge());
+    // Don't tick twice in the cycle in which the CPU stopped
+    Cycles delay(memStalled && curCycle() == lastRunningCycle ? 1 : 0);
+    memStalled = false;
+
+    schedule(tickEvent, clockEdge(delay));
 }
 
 void
 CPU::wakeup(ThreadID tid)
 {
+    // A pending interrupt has to be seen by commit
+    if (memStalled)
+        wakeCPU();
+
     if (thread[tid]->status() != gem5::ThreadContext::Suspended)
         return;
 
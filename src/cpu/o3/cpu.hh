@@ -187,6 +187,11 @@ class CPU : public BaseCPU
      */
     void tick();
 
+    /** Returns if nothing in the pipeline can make progress until an
+     *  outstanding memory access completes.
+     */
+    bool stalledOnMemory();
+
     /** Initialize the CPU */
     void init() override;
 
@@ -535,6 +540,14 @@ class CPU : public BaseCPU
     /** The cycle that the CPU was last running, used for statistics. */
     Cycles lastRunningCycle;
 
+    /** Stop ticking while the pipeline is stalled on memory. */
+    const bool skipStalledCycles;
+
+    /** Whether the CPU stopped ticking because it is stalled on memory
+     *  rather than idle.
+     */
+    bool memStalled;
+
     /** The cycle that the CPU was last activated by a new thread*/
     Tick lastActivatedCycle;
 
@@ -581,6 +594,12 @@ class CPU : public BaseCPU
         /** Stat for total number of cycles the CPU spends descheduled due to a
          * quiesce operation or waiting for an interrupt. */
         statistics::Scalar quiesceCycles;
+        /** Stat for total number of times the CPU stopped ticking while
+         * stalled on memory. */
+        statistics::Scalar stallSkips;
+        /** Stat for total number of cycles skipped while stalled on
+         * memory. */
+        statistics::Scalar stallSkippedCycles;
     } cpuStats;
 
   public:
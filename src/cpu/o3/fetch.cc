@@ -422,6 +422,14 @@ Fetch::isDrained() const
     return !finishTranslationEvent.scheduled();
 }
 
+bool
+Fetch::stalled(ThreadID tid) const
+{
+    return fetchStatus[tid] == Blocked ||
+        fetchStatus[tid] == IcacheWaitResponse ||
+        fetchStatus[tid] == ItlbWait;
+}
+
 void
 Fetch::takeOverFrom()
 {
@@ -558,7 +566,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
     // Setup the memReq to do a read of the first instruction's address.
     // Set the appropriate read size and flags as well.
     // Build request here.
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = Request::create(
         fetchBufferBlockPC, fetchBufferSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
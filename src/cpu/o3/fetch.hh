@@ -241,6 +241,12 @@ class Fetch
     /** Has the stage drained? */
     bool isDrained() const;
 
+    /**
+     * Is the thread waiting on a stall signal, the instruction cache or
+     * the ITLB, rather than fetching?
+     */
+    bool stalled(ThreadID tid) const;
+
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
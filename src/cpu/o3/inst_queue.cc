@@ -559,6 +559,13 @@ InstructionQueue::hasReadyInsts()
     return false;
 }
 
+bool
+InstructionQueue::hasDeferredMemInsts() const
+{
+    return !deferredMemInsts.empty() || !blockedMemInsts.empty() ||
+        !retryMemInsts.empty();
+}
+
 void
 InstructionQueue::insert(const DynInstPtr &new_inst)
 {
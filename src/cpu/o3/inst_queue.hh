@@ -181,6 +181,11 @@ class InstructionQueue
     /** Returns if there are any ready instructions in the IQ. */
     bool hasReadyInsts();
 
+    /** Returns if memory instructions wait for their translation or for
+     *  the cache to unblock before they can be issued again.
+     */
+    bool hasDeferredMemInsts() const;
+
     /** Inserts a new instruction into the IQ. */
     void insert(const DynInstPtr &new_inst);
 
@@ -840,7 +840,7 @@ LSQ::pushRequest(const DynInstPtr& inst, bool isLoad, uint8_t *data,
             inst->effAddrValid(true);
 
             if (cpu->checker) {
-                inst->reqToVerify = std::make_shared<Request>(*request->req());
+                inst->reqToVerify = Request::create(*request->req());
             }
             Fault fault;
             if (isLoad)
@@ -897,6 +897,9 @@ LSQ::SingleDataRequest::finish(const Fault &fault, const RequestPtr &request,
         LSQRequest::_inst->fault = fault;
         LSQRequest::_inst->translationCompleted(true);
     }
+
+    // the CPU may have stopped ticking while waiting on memory
+    _inst->cpu->wakeCPU();
 }
 
 void
@@ -944,6 +947,8 @@ LSQ::SplitDataRequest::finish(const Fault &fault, const RequestPtr &req,
             }
         }
 
+        // the CPU may have stopped ticking while waiting on memory
+        _inst->cpu->wakeCPU();
     }
 }
 
@@ -989,7 +994,7 @@ LSQ::SplitDataRequest::initiateTranslation()
     Addr final_addr = addrBlockAlign(_addr + _size, cacheLineSize);
     uint32_t size_so_far = 0;
 
-    _mainReq = std::make_shared<Request>(base_addr,
+    _mainReq = Request::create(base_addr,
                 _size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId());
     _mainReq->setByteEnable(_byteEnable);
@@ -1106,7 +1111,7 @@ LSQ::LSQRequest::addReq(Addr addr, unsigned size,
            const std::vector<bool>& byte_enable)
 {
     if (isAnyActiveElement(byte_enable.begin(), byte_enable.end())) {
-        auto req = std::make_shared<Request>(
+        auto req = Request::create(
                 addr, size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId(),
                 std::move(_amo_op));
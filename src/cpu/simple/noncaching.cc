@@ -99,7 +99,7 @@ NonCachingSimpleCPU::fetchInstMem()
     auto *bd = bd_it->second;
     Addr offset = ifetch_req->getPaddr() - bd->range().start();
     memcpy(decoder->moreBytesPtr(), bd->ptr() + offset, ifetch_req->getSize());
-    return 0;
+    return bd->latency();
 }
 
 } // namespace gem5
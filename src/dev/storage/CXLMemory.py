@@ -13,6 +13,9 @@ class CXLMemory(PciDevice):
     mem_req_port = RequestPort(
         "This port sends requests to and receives responses from the back-end memory media"
     )
+    nmp_port = RequestPort(
+        "This port connects the near-memory processing engine to the back-end memory media"
+    )
 
     rsp_size = Param.Unsigned(48, "The number of responses to buffer")
     req_size = Param.Unsigned(48, "The number of requests to buffer")
@@ -20,6 +23,25 @@ class CXLMemory(PciDevice):
     proto_proc_lat = Param.Latency("15ns", "Latency of the CXL controller processing CXL.mem sub-protocol packets")
     cxl_mem_range = Param.AddrRange("2GB", "CXL expander memory range that can be identified as system memory")
 
+    ctrl_reg_range = Param.AddrRange(AddrRange(0xFE000000, size="64kB"), "Address range of the CXL device control registers")
+    ctrl_reg_lat = Param.Latency("20ns", "Latency of an access to the CXL device control registers")
+
+    # Persistence domain and Global Persistent Flush (GPF)
+    persistent = Param.Bool(False, "Whether the CXL device memory is part of a persistence domain")
+    persist_on_ack = Param.Bool(False, "Only acknowledge writes once they have become persistent")
+    persist_buf_size = Param.Unsigned(256, "Number of dirty lines the volatile device buffers can hold")
+    persist_line_lat = Param.Latency("5ns", "Latency to make one buffered line persistent")
+    gpf_lat = Param.Latency("1us", "Fixed latency of a Global Persistent Flush")
+
+    # Descriptor ring DMA engine
+    dma_channels = Param.Unsigned(1, "Number of DMA engine channels")
+    dma_chunk_size = Param.Unsigned(256, "Size in bytes of the chunks a DMA channel moves per request")
+    dma_max_outstanding = Param.Unsigned(16, "Maximum number of chunks in flight per DMA channel")
+
+    # Near-memory processing engine
+    nmp_alu_width = Param.Unsigned(8, "Number of elements the near-memory ALU processes per cycle")
+    nmp_max_outstanding = Param.Unsigned(32, "Maximum number of memory accesses in flight of the near-memory engine")
+
     VendorID = 0x8086
     DeviceID = 0X7890
     Command = 0x0
@@ -0,0 +1,228 @@
+#include "dev/storage/cxl_dma_engine.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/CXLDma.hh"
+#include "dev/storage/cxl_memory.hh"
+
+namespace gem5
+{
+
+using namespace cxl_mem_reg;
+
+CXLDmaChannel::CXLDmaChannel(CXLMemory &_cxlMemory, int id,
+                             unsigned chunk_size, unsigned max_outstanding)
+    : cxlMemory(_cxlMemory),
+      _name(csprintf("%s.dma_chan%d", _cxlMemory.name(), id)),
+      chunkSize(chunk_size), maxOutstanding(max_outstanding),
+      ringBase(0), ringSize(0), head(0), tail(0), completed(0),
+      busy(false), desc{}, descStartTick(0), nextOffset(0), bytesDone(0),
+      outstanding(0),
+      fetchCompleteEvent([this]{ fetchDescComplete(); }, name())
+{
+}
+
+uint64_t
+CXLDmaChannel::readReg(Addr offset)
+{
+    switch (offset) {
+      case DMA_RING_BASE:
+        return ringBase;
+      case DMA_RING_SIZE:
+        return ringSize;
+      case DMA_HEAD:
+        return head;
+      case DMA_TAIL:
+        return tail;
+      case DMA_STATUS:
+        return busy ? DMA_STATUS_BUSY : 0;
+      case DMA_COMPLETED:
+        return completed;
+      default:
+        warn("Read from unimplemented DMA register %#x\n", offset);
+        return 0;
+    }
+}
+
+void
+CXLDmaChannel::writeReg(Addr offset, uint64_t val, bool functional)
+{
+    switch (offset) {
+      case DMA_RING_BASE:
+        if (busy) {
+            warn("%s: ring base change ignored while busy\n", name());
+            break;
+        }
+        ringBase = val;
+        break;
+      case DMA_RING_SIZE:
+        if (busy) {
+            warn("%s: ring size change ignored while busy\n", name());
+            break;
+        }
+        if (val == 0) {
+            warn("%s: empty descriptor ring ignored\n", name());
+            break;
+        }
+        ringSize = val;
+        head = tail = 0;
+        break;
+      case DMA_HEAD:
+        if (functional) {
+            if (ringSize)
+                head = val % ringSize;
+            break;
+        }
+        if (ringSize == 0) {
+            warn("%s: doorbell rung without a descriptor ring\n", name());
+            break;
+        }
+        if (cxlMemory.eventQueue() != mainEventQueue[0]) {
+            // the dma port leads back into the host memory system
+            warn_once("%s: the DMA engine is not supported when the device "
+                      "runs on its own event queue\n", name());
+            break;
+        }
+        head = val % ringSize;
+        DPRINTF(CXLDma, "%s: doorbell head %d tail %d\n", name(), head, tail);
+        if (!busy && cxlMemory.drainState() == DrainState::Running)
+            fetchDescriptor();
+        break;
+      default:
+        warn("Write to read-only or unimplemented DMA register %#x\n",
+             offset);
+    }
+}
+
+void
+CXLDmaChannel::fetchDescriptor()
+{
+    assert(!busy);
+
+    if (tail == head)
+        return;
+
+    busy = true;
+    descStartTick = curTick();
+
+    Addr addr = ringBase + tail * sizeof(DmaDesc);
+    DPRINTF(CXLDma, "%s: fetching descriptor %d at %#x\n", name(), tail,
+            addr);
+
+    cxlMemory.dmaRead(addr, sizeof(DmaDesc), &fetchCompleteEvent,
+                      reinterpret_cast<uint8_t *>(&desc));
+}
+
+void
+CXLDmaChannel::fetchDescComplete()
+{
+    DPRINTF(CXLDma, "%s: descriptor src %#x dest %#x len %d\n", name(),
+            desc.src, desc.dest, desc.len);
+
+    nextOffset = 0;
+    bytesDone = 0;
+    outstanding = 0;
+
+    if (desc.len == 0)
+        descComplete();
+    else
+        issueChunks();
+}
+
+void
+CXLDmaChannel::issueChunks()
+{
+    while (outstanding < maxOutstanding && nextOffset < desc.len) {
+        uint64_t offset = nextOffset;
+        unsigned size = std::min<uint64_t>(chunkSize, desc.len - offset);
+        uint8_t *buf = new uint8_t[size];
+
+        nextOffset += size;
+        ++outstanding;
+
+        auto *event = new EventFunctionWrapper(
+            [this, offset, size, buf]{
+                readChunkComplete(offset, size, buf);
+            }, name(), true);
+        cxlMemory.dmaRead(desc.src + offset, size, event, buf);
+    }
+}
+
+void
+CXLDmaChannel::readChunkComplete(uint64_t offset, unsigned size,
+                                 uint8_t *buf)
+{
+    auto *event = new EventFunctionWrapper(
+        [this, size, buf]{ writeChunkComplete(size, buf); }, name(), true);
+    cxlMemory.dmaWrite(desc.dest + offset, size, event, buf);
+}
+
+void
+CXLDmaChannel::writeChunkComplete(unsigned size, uint8_t *buf)
+{
+    delete [] buf;
+
+    assert(outstanding > 0);
+    --outstanding;
+    bytesDone += size;
+
+    if (bytesDone < desc.len)
+        issueChunks();
+    else
+        descComplete();
+}
+
+void
+CXLDmaChannel::descComplete()
+{
+    assert(outstanding == 0);
+
+    DPRINTF(CXLDma, "%s: descriptor %d complete, %d bytes\n", name(), tail,
+            desc.len);
+
+    cxlMemory.stats.dmaDescriptors++;
+    cxlMemory.stats.dmaBytes += desc.len;
+    cxlMemory.stats.dmaTotalLat += curTick() - descStartTick;
+
+    tail = (tail + 1) % ringSize;
+    ++completed;
+    busy = false;
+
+    if (cxlMemory.drainState() == DrainState::Running)
+        fetchDescriptor();
+    else
+        cxlMemory.engineIdle();
+}
+
+void
+CXLDmaChannel::drainResume()
+{
+    if (!busy)
+        fetchDescriptor();
+}
+
+void
+CXLDmaChannel::serialize(CheckpointOut &cp) const
+{
+    // the device only drains once all channels are idle
+    assert(!busy);
+
+    SERIALIZE_SCALAR(ringBase);
+    SERIALIZE_SCALAR(ringSize);
+    SERIALIZE_SCALAR(head);
+    SERIALIZE_SCALAR(tail);
+    SERIALIZE_SCALAR(completed);
+}
+
+void
+CXLDmaChannel::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_SCALAR(ringBase);
+    UNSERIALIZE_SCALAR(ringSize);
+    UNSERIALIZE_SCALAR(head);
+    UNSERIALIZE_SCALAR(tail);
+    UNSERIALIZE_SCALAR(completed);
+}
+
+} // namespace gem5
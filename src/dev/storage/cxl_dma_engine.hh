@@ -0,0 +1,110 @@
+/* @file
+ * Descriptor ring DMA engine of the CXL memory expander
+ */
+
+#ifndef __DEV_STORAGE_CXL_DMA_ENGINE_HH__
+#define __DEV_STORAGE_CXL_DMA_ENGINE_HH__
+
+#include <string>
+
+#include "base/types.hh"
+#include "dev/storage/cxl_memory_defs.hh"
+#include "sim/eventq.hh"
+#include "sim/serialize.hh"
+
+namespace gem5
+{
+
+class CXLMemory;
+
+/**
+ * One channel of the DMA engine of CXLMemory. The host fills a ring of
+ * descriptors in its memory and rings the doorbell by writing the
+ * producer index to DMA_HEAD. The channel fetches descriptors from the
+ * ring and copies them chunk by chunk through the dma port of the
+ * device, with up to a configurable number of chunks in flight, and
+ * advances DMA_TAIL as descriptors complete.
+ *
+ * Accesses to the CXL memory range are routed by the IO crossbar
+ * straight to the device without snooping the host caches, so the
+ * host is expected to flush or not cache the destination lines, as
+ * for a CXL type 3 device without back-invalidation.
+ */
+class CXLDmaChannel : public Serializable
+{
+  private:
+    /** The device this channel belongs to. */
+    CXLMemory &cxlMemory;
+
+    const std::string _name;
+
+    /** Size of the data chunks moved per DMA request. */
+    const unsigned chunkSize;
+
+    /** Maximum number of chunks in flight. */
+    const unsigned maxOutstanding;
+
+    /** Host visible registers. */
+    Addr ringBase;
+    uint64_t ringSize;
+    uint64_t head;
+    uint64_t tail;
+    uint64_t completed;
+
+    /** Is a descriptor being fetched or copied. */
+    bool busy;
+
+    /** The descriptor being copied. */
+    cxl_mem_reg::DmaDesc desc;
+
+    /** When did the channel start on the current descriptor. */
+    Tick descStartTick;
+
+    /** Offset of the next chunk of the descriptor to read. */
+    uint64_t nextOffset;
+
+    /** Bytes of the current descriptor written to the destination. */
+    uint64_t bytesDone;
+
+    /** Number of chunks read or written but not yet completed. */
+    unsigned outstanding;
+
+    EventFunctionWrapper fetchCompleteEvent;
+
+    /** Start on the next descriptor of the ring, if any. */
+    void fetchDescriptor();
+    void fetchDescComplete();
+
+    /** Issue chunk reads until the outstanding limit is reached. */
+    void issueChunks();
+    void readChunkComplete(uint64_t offset, unsigned size, uint8_t *buf);
+    void writeChunkComplete(unsigned size, uint8_t *buf);
+
+    /** Retire the current descriptor and move on to the next one. */
+    void descComplete();
+
+  public:
+    CXLDmaChannel(CXLMemory &_cxlMemory, int id, unsigned chunk_size,
+                  unsigned max_outstanding);
+
+    const std::string &name() const { return _name; }
+
+    /**
+     * Access a register of the channel block. A functional write of the
+     * head updates it without ringing the doorbell.
+     */
+    uint64_t readReg(Addr offset);
+    void writeReg(Addr offset, uint64_t val, bool functional);
+
+    bool isBusy() const { return busy; }
+
+    /** Pick up descriptors posted while the device was draining. */
+    void drainResume();
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+};
+
+} // namespace gem5
+
+#endif // __DEV_STORAGE_CXL_DMA_ENGINE_HH__
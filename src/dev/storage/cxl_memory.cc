@@ -1,6 +1,10 @@
+#include "base/binary_trace.hh"
 #include "base/trace.hh"
 #include "dev/storage/cxl_memory.hh"
+#include "dev/storage/cxl_memory_defs.hh"
 #include "debug/CXLMemory.hh"
+#include "sim/stats.hh"
+#include "sim/system.hh"
 
 namespace gem5
 {
@@ -35,11 +39,40 @@ CXLMemory::CXLMemory(const Params &p)
             ticksToCycles(p.proto_proc_lat), p.rsp_size, p.cxl_mem_range),
     memReqPort(p.name + ".mem_req_port", *this, cxlRspPort,
             ticksToCycles(p.proto_proc_lat), p.req_size),
-    preRspTick(0),        
+    preRspTick(0),
+    traceId(binary_trace::objectId(p.name)),
+    ctrlRegRange(p.ctrl_reg_range),
+    ctrlRegLat(ticksToCycles(p.ctrl_reg_lat)),
+    persistent(p.persistent), persistOnAck(p.persist_on_ack),
+    persistBufSize(p.persist_buf_size),
+    persistLineLat(p.persist_line_lat), gpfLat(p.gpf_lat),
+    dirtyLines(0), dirtyUpdateTick(0), gpfDoneTick(0), gpfFlushes(0),
+    nmpEngine(*this, p.cxl_mem_range, p.nmp_alu_width,
+              p.nmp_max_outstanding),
     stats(*this)
     {
         DPRINTF(CXLMemory, "BAR0_addr:0x%lx, BAR0_size:0x%lx\n",
             p.BAR0->addr(), p.BAR0->size());
+        fatal_if(persistent && persistLineLat == 0,
+                 "%s: persist_line_lat must be non-zero for a persistent "
+                 "device\n", name());
+
+        using namespace cxl_mem_reg;
+        fatal_if(DMA_BASE + p.dma_channels * DMA_CHAN_SIZE > NMP_BASE,
+                 "%s: %d DMA channels do not fit in the control register "
+                 "window\n", name(), p.dma_channels);
+        fatal_if(NMP_BASE + NMP_SIZE > ctrlRegRange.size(),
+                 "%s: ctrl_reg_range is too small\n", name());
+        fatal_if(p.nmp_alu_width == 0 || p.nmp_max_outstanding == 0,
+                 "%s: NMP ALU width and outstanding accesses must be "
+                 "non-zero\n", name());
+        fatal_if(p.dma_chunk_size == 0 || p.dma_max_outstanding == 0,
+                 "%s: DMA chunk size and outstanding chunks must be "
+                 "non-zero\n", name());
+        for (int i = 0; i < p.dma_channels; i++) {
+            dmaChannels.emplace_back(new CXLDmaChannel(*this, i,
+                p.dma_chunk_size, p.dma_max_outstanding));
+        }
     }
 
 CXLMemory::CXLCtrlStats::CXLCtrlStats(CXLMemory &_cxlMemory)
@@ -65,7 +98,58 @@ CXLMemory::CXLCtrlStats::CXLCtrlStats(CXLMemory &_cxlMemory)
       ADD_STAT(reqQueueLatDist, "Response queue latency distribution (Tick)"),
       ADD_STAT(rspQueueLatDist, "Response queue latency distribution (Tick)"),
       ADD_STAT(memToCXLCtrlRsp, "Distribution of the time intervals between "
-               "consecutive mem responses from the memory media to the CXLCtrl (Cycle)")
+               "consecutive mem responses from the memory media to the CXLCtrl (Cycle)"),
+      ADD_STAT(volatileWriteAcks, statistics::units::Count::get(),
+               "Number of writes acknowledged before becoming persistent"),
+      ADD_STAT(persistentWriteAcks, statistics::units::Count::get(),
+               "Number of writes acknowledged after becoming persistent"),
+      ADD_STAT(persistBufFullEvents, statistics::units::Count::get(),
+               "Number of times a write stalled on the full device buffers"),
+      ADD_STAT(gpfCount, statistics::units::Count::get(),
+               "Number of Global Persistent Flushes"),
+      ADD_STAT(gpfFlushedLines, statistics::units::Count::get(),
+               "Number of dirty lines written back by Global Persistent Flushes"),
+      ADD_STAT(gpfTotalLat, statistics::units::Tick::get(),
+               "Total latency of Global Persistent Flushes"),
+      ADD_STAT(avgGpfLat, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Average latency of a Global Persistent Flush",
+               gpfTotalLat / gpfCount),
+      ADD_STAT(dmaDescriptors, statistics::units::Count::get(),
+               "Number of descriptors completed by the DMA engine"),
+      ADD_STAT(dmaBytes, statistics::units::Byte::get(),
+               "Number of bytes copied by the DMA engine"),
+      ADD_STAT(dmaTotalLat, statistics::units::Tick::get(),
+               "Total latency of DMA descriptors"),
+      ADD_STAT(avgDmaLat, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Average latency of a DMA descriptor",
+               dmaTotalLat / dmaDescriptors),
+      ADD_STAT(dmaBandwidth, statistics::units::Rate<
+                    statistics::units::Byte, statistics::units::Second>::get(),
+               "Average bandwidth of the DMA engine",
+               dmaBytes / simSeconds),
+      ADD_STAT(nmpCommands, statistics::units::Count::get(),
+               "Number of commands executed by the NMP engine"),
+      ADD_STAT(nmpBytesRead, statistics::units::Byte::get(),
+               "Number of bytes the NMP engine read from the memory media "
+               "instead of the host over the CXL link"),
+      ADD_STAT(nmpBytesWritten, statistics::units::Byte::get(),
+               "Number of bytes the NMP engine wrote to the memory media"),
+      ADD_STAT(nmpAluCycles, statistics::units::Cycle::get(),
+               "Number of cycles the NMP ALU was busy"),
+      ADD_STAT(nmpTotalLat, statistics::units::Tick::get(),
+               "Total latency of NMP commands"),
+      ADD_STAT(avgNmpLat, statistics::units::Rate<
+                    statistics::units::Tick, statistics::units::Count>::get(),
+               "Average latency of an NMP command",
+               nmpTotalLat / nmpCommands),
+      ADD_STAT(atomicAccesses, statistics::units::Count::get(),
+               "Number of atomic accesses that reached the device"),
+      ADD_STAT(atomicLat, statistics::units::Tick::get(),
+               "Total latency of the atomic accesses that reached the device"),
+      ADD_STAT(backdoorsGranted, statistics::units::Count::get(),
+               "Number of backdoors to the back-end memory media handed out")
 {
     reqQueueLenDist
         .init(0, 49, 10)
@@ -96,6 +180,8 @@ CXLMemory::getPort(const std::string &if_name, PortID idx)
         return memReqPort;
     else if (if_name == "dma")
         return dmaPort;
+    else if (if_name == "nmp_port")
+        return nmpEngine.getPort();
     else
         return PioDevice::getPort(if_name, idx);
 }
@@ -115,6 +201,253 @@ CXLMemory::getAddrRanges() const
     return PciDevice::getAddrRanges();
 }
 
+Tick
+CXLMemory::read(PacketPtr pkt)
+{
+    if (!ctrlRegRange.contains(pkt->getAddr()))
+        return cxlRspPort.recvAtomic(pkt);
+
+    pkt->setLE<uint64_t>(readReg(pkt));
+    pkt->makeAtomicResponse();
+    return cyclesToTicks(ctrlRegLat);
+}
+
+Tick
+CXLMemory::write(PacketPtr pkt)
+{
+    if (!ctrlRegRange.contains(pkt->getAddr()))
+        return cxlRspPort.recvAtomic(pkt);
+
+    // the write is only acknowledged once its side effects are done,
+    // so that a host waiting on the ack observes the full flush cost
+    Tick delay = cyclesToTicks(ctrlRegLat) + writeReg(pkt, false);
+    pkt->makeAtomicResponse();
+    return delay;
+}
+
+void
+CXLMemory::accessRegFunctional(PacketPtr pkt)
+{
+    if (pkt->isRead())
+        pkt->setLE<uint64_t>(readReg(pkt));
+    else
+        writeReg(pkt, true);
+    pkt->makeResponse();
+}
+
+uint64_t
+CXLMemory::readReg(PacketPtr pkt)
+{
+    using namespace cxl_mem_reg;
+
+    Addr daddr = pkt->getAddr() - ctrlRegRange.start();
+    panic_if(pkt->getSize() != sizeof(uint64_t),
+             "Unsupported size %d for CXL register read at %#x\n",
+             pkt->getSize(), daddr);
+
+    uint64_t val = 0;
+    if (daddr >= DMA_BASE &&
+        daddr < DMA_BASE + dmaChannels.size() * DMA_CHAN_SIZE) {
+        Addr chan = (daddr - DMA_BASE) / DMA_CHAN_SIZE;
+        val = dmaChannels[chan]->readReg((daddr - DMA_BASE) % DMA_CHAN_SIZE);
+    } else if (daddr >= NMP_BASE && daddr < NMP_BASE + NMP_SIZE) {
+        val = nmpEngine.readReg(daddr - NMP_BASE);
+    } else switch (daddr) {
+      case GPF_CTRL:
+        break;
+      case GPF_STATUS:
+        val = (curTick() < gpfDoneTick ? GPF_STATUS_BUSY : 0) |
+              (persistent ? GPF_STATUS_PERSISTENT : 0);
+        break;
+      case GPF_DIRTY_LINES:
+        updateDirtyLines();
+        val = dirtyLines;
+        break;
+      case GPF_COUNT:
+        val = gpfFlushes;
+        break;
+      default:
+        warn("Read from unimplemented CXL register %#x\n", daddr);
+    }
+
+    DPRINTF(CXLMemory, "Read register %#x: %#x\n", daddr, val);
+    return val;
+}
+
+Tick
+CXLMemory::writeReg(PacketPtr pkt, bool functional)
+{
+    using namespace cxl_mem_reg;
+
+    Addr daddr = pkt->getAddr() - ctrlRegRange.start();
+    panic_if(pkt->getSize() != sizeof(uint64_t),
+             "Unsupported size %d for CXL register write at %#x\n",
+             pkt->getSize(), daddr);
+
+    uint64_t val = pkt->getLE<uint64_t>();
+    DPRINTF(CXLMemory, "Write register %#x: %#x\n", daddr, val);
+
+    Tick delay = 0;
+    if (daddr >= DMA_BASE &&
+        daddr < DMA_BASE + dmaChannels.size() * DMA_CHAN_SIZE) {
+        Addr chan = (daddr - DMA_BASE) / DMA_CHAN_SIZE;
+        dmaChannels[chan]->writeReg((daddr - DMA_BASE) % DMA_CHAN_SIZE, val,
+                                    functional);
+    } else if (daddr >= NMP_BASE && daddr < NMP_BASE + NMP_SIZE) {
+        nmpEngine.writeReg(daddr - NMP_BASE, val, functional);
+    } else switch (daddr) {
+      case GPF_CTRL:
+        if ((val & GPF_CTRL_START) && !functional)
+            delay += globalPersistentFlush();
+        break;
+      default:
+        warn("Write to read-only or unimplemented CXL register %#x\n",
+             daddr);
+    }
+
+    return delay;
+}
+
+void
+CXLMemory::updateDirtyLines()
+{
+    if (curTick() <= dirtyUpdateTick)
+        return;
+
+    uint64_t drained = (curTick() - dirtyUpdateTick) / persistLineLat;
+    if (drained >= dirtyLines) {
+        dirtyLines = 0;
+        dirtyUpdateTick = curTick();
+    } else {
+        dirtyLines -= drained;
+        dirtyUpdateTick += drained * persistLineLat;
+    }
+}
+
+Tick
+CXLMemory::persistWrite(PacketPtr pkt)
+{
+    if (!persistent)
+        return 0;
+
+    uint64_t lines = divCeil(pkt->getSize(), sys->cacheLineSize());
+
+    if (persistOnAck) {
+        // write-through to the persistence domain before the ack
+        stats.persistentWriteAcks++;
+        return lines * persistLineLat;
+    }
+
+    stats.volatileWriteAcks++;
+
+    updateDirtyLines();
+    dirtyLines += lines;
+    if (dirtyLines <= persistBufSize)
+        return 0;
+
+    // the buffers are full, so the write has to wait for the oldest
+    // lines to drain, during which the drain engine is busy
+    stats.persistBufFullEvents++;
+    Tick stall = (dirtyLines - persistBufSize) * persistLineLat;
+    dirtyLines = persistBufSize;
+    dirtyUpdateTick = std::max(dirtyUpdateTick, curTick()) + stall;
+
+    DPRINTF(CXLMemory, "Device buffers full, write stalls %ld ticks\n",
+            stall);
+    return stall;
+}
+
+Tick
+CXLMemory::globalPersistentFlush()
+{
+    updateDirtyLines();
+
+    // a new flush has to wait for one that is still in progress
+    Tick start = std::max(curTick(), gpfDoneTick);
+    Tick lat = start - curTick() + gpfLat + dirtyLines * persistLineLat;
+
+    DPRINTF(CXLMemory, "Global Persistent Flush of %d dirty lines, "
+            "latency %ld\n", dirtyLines, lat);
+
+    gpfFlushes++;
+    stats.gpfCount++;
+    stats.gpfFlushedLines += dirtyLines;
+    stats.gpfTotalLat += lat;
+
+    dirtyLines = 0;
+    gpfDoneTick = curTick() + lat;
+    dirtyUpdateTick = gpfDoneTick;
+
+    return lat;
+}
+
+void
+CXLMemory::serialize(CheckpointOut &cp) const
+{
+    PciDevice::serialize(cp);
+
+    SERIALIZE_SCALAR(dirtyLines);
+    SERIALIZE_SCALAR(gpfFlushes);
+
+    for (int i = 0; i < dmaChannels.size(); i++)
+        dmaChannels[i]->serializeSection(cp, csprintf("dma_chan%d", i));
+
+    nmpEngine.serializeSection(cp, "nmp");
+}
+
+void
+CXLMemory::unserialize(CheckpointIn &cp)
+{
+    PciDevice::unserialize(cp);
+
+    UNSERIALIZE_SCALAR(dirtyLines);
+    UNSERIALIZE_OPT_SCALAR(gpfFlushes);
+    dirtyUpdateTick = curTick();
+
+    for (int i = 0; i < dmaChannels.size(); i++)
+        dmaChannels[i]->unserializeSection(cp, csprintf("dma_chan%d", i));
+
+    {
+        // Older checkpoints have no NMP section, the engine then keeps
+        // its reset values.
+        ScopedCheckpointSection sec(cp, "nmp");
+        if (cp.sectionExists(Serializable::currentSection()))
+            nmpEngine.unserialize(cp);
+    }
+}
+
+bool
+CXLMemory::enginesBusy() const
+{
+    for (auto &chan : dmaChannels) {
+        if (chan->isBusy())
+            return true;
+    }
+    return nmpEngine.isBusy();
+}
+
+DrainState
+CXLMemory::drain()
+{
+    return enginesBusy() ? DrainState::Draining : DrainState::Drained;
+}
+
+void
+CXLMemory::drainResume()
+{
+    PciDevice::drainResume();
+
+    for (auto &chan : dmaChannels)
+        chan->drainResume();
+}
+
+void
+CXLMemory::engineIdle()
+{
+    if (drainState() == DrainState::Draining && !enginesBusy())
+        signalDrainDone();
+}
+
 bool
 CXLMemory::CXLResponsePort::respQueueFull() const
 {
@@ -142,10 +475,8 @@ CXLMemory::CXLRequestPort::recvTimingResp(PacketPtr pkt)
 {
     // all checks are done when the request is accepted on the response
     // side, so we are guaranteed to have space for the response
-    DPRINTF(CXLMemory, "recvTimingResp: %s addr 0x%x\n",
-            pkt->cmdString(), pkt->getAddr());
-
-    DPRINTF(CXLMemory, "Request queue size: %d\n", transmitList.size());
+    BTRACE(CXLMemory, cxlMemory.traceId, "recvTimingResp", pkt->getAddr(),
+           pkt->cmdToIndex(), transmitList.size());
 
     if (cxlMemory.preRspTick == -1) {
         cxlMemory.preRspTick = cxlMemory.clockEdge();
@@ -169,17 +500,17 @@ CXLMemory::CXLRequestPort::recvTimingResp(PacketPtr pkt)
 bool
 CXLMemory::CXLResponsePort::recvTimingReq(PacketPtr pkt)
 {
-    DPRINTF(CXLMemory, "recvTimingReq: %s addr 0x%x\n",
-            pkt->cmdString(), pkt->getAddr());
-
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
 
     if (retryReq)
         return false;
 
-    DPRINTF(CXLMemory, "Response queue size: %d outresp: %d\n",
-            transmitList.size(), outstandingResponses);
+    if (cxlMemory.ctrlRegRange.contains(pkt->getAddr()))
+        return recvCtrlTimingReq(pkt);
+
+    BTRACE(CXLMemory, cxlMemory.traceId, "recvTimingReq", pkt->getAddr(),
+           pkt->cmdToIndex(), transmitList.size());
 
     // if the request queue is full then there is no hope
     if (memReqPort.reqQueueFull()) {
@@ -194,7 +525,6 @@ CXLMemory::CXLResponsePort::recvTimingReq(PacketPtr pkt)
                 retryReq = true;
             } else {
                 // ok to send the request with space for the response
-                DPRINTF(CXLMemory, "Reserving space for response\n");
                 assert(outstandingResponses != respQueueLimit);
                 ++outstandingResponses;
 
@@ -208,8 +538,14 @@ CXLMemory::CXLResponsePort::recvTimingReq(PacketPtr pkt)
             Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
             pkt->headerDelay = pkt->payloadDelay = 0;
 
+            // account the persistence of every write the device accepts,
+            // including the writebacks of the caches, which get no
+            // response, by holding it until the buffers have room for it
+            Tick persist_delay =
+                pkt->isWrite() ? cxlMemory.persistWrite(pkt) : 0;
+
             memReqPort.schedTimingReq(pkt, cxlMemory.clockEdge(protoProcLat) +
-                                      receive_delay);
+                                      receive_delay + persist_delay);
         }
     }
 
@@ -220,6 +556,35 @@ CXLMemory::CXLResponsePort::recvTimingReq(PacketPtr pkt)
     return !retryReq;
 }
 
+bool
+CXLMemory::CXLResponsePort::recvCtrlTimingReq(PacketPtr pkt)
+{
+    bool expects_response = pkt->needsResponse();
+    if (expects_response) {
+        if (respQueueFull()) {
+            DPRINTF(CXLMemory, "Response queue full\n");
+            retryReq = true;
+            return false;
+        }
+        ++outstandingResponses;
+    }
+
+    Tick receive_delay = pkt->headerDelay + pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    Tick access_delay = pkt->isRead() ? cxlMemory.read(pkt) :
+                                        cxlMemory.write(pkt);
+
+    if (expects_response) {
+        schedTimingResp(pkt, cxlMemory.clockEdge(protoProcLat) +
+                        receive_delay + access_delay);
+    } else {
+        pendingDelete.reset(pkt);
+    }
+
+    return true;
+}
+
 void
 CXLMemory::CXLResponsePort::retryStalledReq()
 {
@@ -272,8 +637,8 @@ CXLMemory::CXLRequestPort::trySendTiming()
 
     PacketPtr pkt = req.pkt;
 
-    DPRINTF(CXLMemory, "trySend request addr 0x%x, queue size %d\n",
-            pkt->getAddr(), transmitList.size());
+    BTRACE(CXLMemory, cxlMemory.traceId, "sendTimingReq", pkt->getAddr(),
+           pkt->cmdToIndex(), transmitList.size());
 
     if (sendTimingReq(pkt)) {
         // send successful
@@ -283,12 +648,10 @@ CXLMemory::CXLRequestPort::trySendTiming()
         transmitList.pop_front();
 
         cxlMemory.stats.reqQueueLenDist.sample(transmitList.size());
-        DPRINTF(CXLMemory, "trySend request successful\n");
 
         // If there are more packets to send, schedule event to try again.
         if (!transmitList.empty()) {
             DeferredPacket next_req = transmitList.front();
-            DPRINTF(CXLMemory, "Scheduling next send\n");
             cxlMemory.schedule(sendEvent, std::max(next_req.tick,
                                                 cxlMemory.clockEdge()));
         }
@@ -317,8 +680,8 @@ CXLMemory::CXLResponsePort::trySendTiming()
 
     PacketPtr pkt = resp.pkt;
 
-    DPRINTF(CXLMemory, "trySend response addr 0x%x, outstanding %d\n",
-            pkt->getAddr(), outstandingResponses);
+    BTRACE(CXLMemory, cxlMemory.traceId, "sendTimingResp", pkt->getAddr(),
+           pkt->cmdToIndex(), outstandingResponses);
 
     if (sendTimingResp(pkt)) {
         // send successful
@@ -328,7 +691,6 @@ CXLMemory::CXLResponsePort::trySendTiming()
         transmitList.pop_front();
 
         cxlMemory.stats.rspQueueLenDist.sample(transmitList.size());
-        DPRINTF(CXLMemory, "trySend response successful\n");
 
         assert(outstandingResponses != 0);
         --outstandingResponses;
@@ -338,7 +700,6 @@ CXLMemory::CXLResponsePort::trySendTiming()
         // If there are more packets to send, schedule event to try again.
         if (!transmitList.empty()) {
             DeferredPacket next_resp = transmitList.front();
-            DPRINTF(CXLMemory, "Scheduling next send\n");
             cxlMemory.schedule(sendEvent, std::max(next_resp.tick,
                                                 cxlMemory.clockEdge()));
         }
@@ -360,6 +721,23 @@ CXLMemory::CXLResponsePort::trySendTiming()
     // and therefore there is no need to take any action
 }
 
+bool
+CXLMemory::CXLRequestPort::trySatisfyFunctional(PacketPtr pkt)
+{
+    bool found = false;
+    auto i = transmitList.begin();
+
+    while (i != transmitList.end() && !found) {
+        if (pkt->trySatisfyFunctional((*i).pkt)) {
+            pkt->makeResponse();
+            found = true;
+        }
+        ++i;
+    }
+
+    return found;
+}
+
 void
 CXLMemory::CXLRequestPort::recvReqRetry()
 {
@@ -379,24 +757,102 @@ CXLMemory::CXLResponsePort::recvAtomic(PacketPtr pkt)
             pkt->cmdString(), pkt->getAddrRange().to_string());
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
-    
+
+    if (cxlMemory.ctrlRegRange.contains(pkt->getAddr())) {
+        return protoProcLat * cxlMemory.clockPeriod() +
+               (pkt->isRead() ? cxlMemory.read(pkt) : cxlMemory.write(pkt));
+    }
+
     Cycles delay = processCXLMem(pkt);
 
     Tick access_delay = memReqPort.sendAtomic(pkt);
+    if (pkt->isWrite())
+        access_delay += cxlMemory.persistWrite(pkt);
 
     DPRINTF(CXLMemory, "access_delay=%ld, proto_proc_lat=%ld, total=%ld\n",
             access_delay, delay, delay * cxlMemory.clockPeriod() + access_delay);
-    return delay * cxlMemory.clockPeriod() + access_delay;
+
+    Tick total = delay * cxlMemory.clockPeriod() + access_delay;
+    cxlMemory.stats.atomicAccesses++;
+    cxlMemory.stats.atomicLat += total;
+    return total;
 }
 
 Tick
 CXLMemory::CXLResponsePort::recvAtomicBackdoor(
     PacketPtr pkt, MemBackdoorPtr &backdoor)
 {
+    // the registers and the persistence domain cannot be bypassed
+    if (cxlMemory.ctrlRegRange.contains(pkt->getAddr()) ||
+        cxlMemory.persistent) {
+        return recvAtomic(pkt);
+    }
+
     Cycles delay = processCXLMem(pkt);
 
-    return delay * cxlMemory.clockPeriod() + memReqPort.sendAtomicBackdoor(
-        pkt, backdoor);
+    Tick total = delay * cxlMemory.clockPeriod() +
+        memReqPort.sendAtomicBackdoor(pkt, backdoor);
+
+    // accesses through a granted backdoor no longer reach the device, so
+    // only the accesses that do are counted. Their holders are charged
+    // the latency of the access that got the backdoor instead.
+    cxlMemory.stats.atomicAccesses++;
+    cxlMemory.stats.atomicLat += total;
+    if (backdoor) {
+        backdoor->latency(total);
+        cxlMemory.stats.backdoorsGranted++;
+    }
+
+    return total;
+}
+
+void
+CXLMemory::CXLResponsePort::recvMemBackdoorReq(
+    const MemBackdoorReq &req, MemBackdoorPtr &backdoor)
+{
+    // the registers and the persistence domain cannot be bypassed
+    if (req.range().intersects(cxlMemory.ctrlRegRange) ||
+        cxlMemory.persistent) {
+        return;
+    }
+
+    memReqPort.sendMemBackdoorReq(req, backdoor);
+    if (backdoor) {
+        // there is no access to time, so only the protocol is charged
+        backdoor->latency((protoProcLat + protoProcLat) *
+                          cxlMemory.clockPeriod());
+        cxlMemory.stats.backdoorsGranted++;
+    }
+}
+
+void
+CXLMemory::CXLResponsePort::recvFunctional(PacketPtr pkt)
+{
+    if (cxlMemory.ctrlRegRange.contains(pkt->getAddr())) {
+        cxlMemory.accessRegFunctional(pkt);
+        return;
+    }
+
+    pkt->pushLabel(name());
+
+    // check the response queue
+    for (auto i = transmitList.begin(); i != transmitList.end(); ++i) {
+        if (pkt->trySatisfyFunctional((*i).pkt)) {
+            pkt->makeResponse();
+            pkt->popLabel();
+            return;
+        }
+    }
+
+    // also check the request queue
+    if (memReqPort.trySatisfyFunctional(pkt)) {
+        pkt->popLabel();
+        return;
+    }
+
+    pkt->popLabel();
+
+    memReqPort.sendFunctional(pkt);
 }
 
 Cycles
@@ -413,6 +869,7 @@ AddrRangeList
 CXLMemory::CXLResponsePort::getAddrRanges() const {
     AddrRangeList ranges = cxlMemory.getAddrRanges();
     ranges.push_back(cxlMemRange);
+    ranges.push_back(cxlMemory.ctrlRegRange);
     return ranges;
 }
 
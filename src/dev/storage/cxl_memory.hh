@@ -2,12 +2,16 @@
 #define __DEV_STORAGE_CXL_MEMORY_HH__
 
 #include <deque>
+#include <memory>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "base/statistics.hh"
 #include "dev/pci/device.hh"
+#include "dev/storage/cxl_dma_engine.hh"
+#include "dev/storage/cxl_nmp_engine.hh"
 #include "mem/packet.hh"
 #include "mem/packet_access.hh"
 #include "mem/port.hh"
@@ -20,6 +24,9 @@ namespace gem5
 
 class CXLMemory : public PciDevice 
 {
+    friend class CXLDmaChannel;
+    friend class CXLNmpEngine;
+
     protected:
 
         /**
@@ -104,6 +111,15 @@ class CXLMemory : public PciDevice
                 /** Send event for the response queue. */
                 EventFunctionWrapper sendEvent;
 
+                /**
+                * Handle a timing request to the control register window
+                * of the device. The request is served by the device
+                * itself rather than by the back-end memory media.
+                *
+                * @return true if the request was accepted
+                */
+                bool recvCtrlTimingReq(PacketPtr pkt);
+
             public:
                 /**
                 * Constructor for the CXLResponsePort.
@@ -151,10 +167,14 @@ class CXLMemory : public PciDevice
                 Tick recvAtomicBackdoor(
                     PacketPtr pkt, MemBackdoorPtr &backdoor) override;
 
+                /** When receiving a backdoor request from the Host,
+                    pass it to the back-end memory media. */
                 void recvMemBackdoorReq(
-                    const MemBackdoorReq &req, MemBackdoorPtr &backdoor) override {};
+                    const MemBackdoorReq &req, MemBackdoorPtr &backdoor) override;
 
-                void recvFunctional(PacketPtr pkt) override {};
+                /** When receiving a Functional request from the Host,
+                    pass it to the back-end memory media. */
+                void recvFunctional(PacketPtr pkt) override;
 
                 /** When receiving a address range request the Host,
                     pass it to the back-end memory media. */
@@ -233,6 +253,16 @@ class CXLMemory : public PciDevice
                 */
                 void schedTimingReq(PacketPtr pkt, Tick when);
 
+                /**
+                * Check a functional request against the packets in our
+                * request queue.
+                *
+                * @param pkt packet to check against
+                *
+                * @return true if we find a match
+                */
+                bool trySatisfyFunctional(PacketPtr pkt);
+
             protected:
                 /** When receiving a timing request from the back-end memory media,
                     pass it to the Host. */
@@ -251,6 +281,107 @@ class CXLMemory : public PciDevice
 
         Tick preRspTick = -1;
 
+        /** Id of the device in binary traces. */
+        const uint32_t traceId;
+
+        /** Address range of the device control registers. */
+        const AddrRange ctrlRegRange;
+
+        /** Latency of an access to the device control registers. */
+        const Cycles ctrlRegLat;
+
+        /** Is the device memory part of a persistence domain. */
+        const bool persistent;
+
+        /** Only acknowledge writes once they have become persistent. */
+        const bool persistOnAck;
+
+        /** Number of dirty lines the volatile device buffers can hold. */
+        const uint64_t persistBufSize;
+
+        /** Latency to make one buffered line persistent. */
+        const Tick persistLineLat;
+
+        /** Fixed latency of a Global Persistent Flush. */
+        const Tick gpfLat;
+
+        /**
+        * Number of lines that have been acknowledged to the host but
+        * are still held in the volatile device buffers.
+        */
+        uint64_t dirtyLines;
+
+        /**
+        * Tick up to which the background drain of the device buffers
+        * has been accounted for in dirtyLines.
+        */
+        Tick dirtyUpdateTick;
+
+        /** Tick at which the last Global Persistent Flush completes. */
+        Tick gpfDoneTick;
+
+        /**
+        * Number of Global Persistent Flushes, as the host reads it. Unlike
+        * the stat, it survives stat resets.
+        */
+        uint64_t gpfFlushes;
+
+        /**
+        * Retire the dirty lines that the background drain has made
+        * persistent since the last update.
+        */
+        void updateDirtyLines();
+
+        /**
+        * Account a write accepted by the device, writebacks included,
+        * in the persistence domain.
+        *
+        * @param pkt the write request
+        * @return extra delay before the write can proceed
+        */
+        Tick persistWrite(PacketPtr pkt);
+
+        /**
+        * Flush all dirty lines of the device buffers to the
+        * persistence domain.
+        *
+        * @return the latency of the flush
+        */
+        Tick globalPersistentFlush();
+
+        /**
+        * Read a control register.
+        *
+        * @param pkt the read request
+        * @return the value of the register
+        */
+        uint64_t readReg(PacketPtr pkt);
+
+        /**
+        * Write a control register.
+        *
+        * @param pkt the write request
+        * @param functional only update the register, without starting a
+        *                   flush or the DMA and NMP engines
+        * @return extra delay of the side effects of the write
+        */
+        Tick writeReg(PacketPtr pkt, bool functional);
+
+        /** Channels of the DMA engine. */
+        std::vector<std::unique_ptr<CXLDmaChannel>> dmaChannels;
+
+        /** Near-memory processing engine. */
+        CXLNmpEngine nmpEngine;
+
+        /** Is any DMA channel or the NMP engine busy. */
+        bool enginesBusy() const;
+
+        /**
+        * Called by an engine that became idle, to complete a drain of
+        * the device once all engines are idle.
+        */
+        void engineIdle();
+
         struct CXLCtrlStats : public statistics::Group
         {
             CXLCtrlStats(CXLMemory &cxlMemory);
@@ -268,17 +399,38 @@ class CXLMemory : public PciDevice
             statistics::Distribution reqQueueLatDist;
             statistics::Distribution rspQueueLatDist;
             statistics::Distribution memToCXLCtrlRsp;
+            statistics::Scalar volatileWriteAcks;
+            statistics::Scalar persistentWriteAcks;
+            statistics::Scalar persistBufFullEvents;
+            statistics::Scalar gpfCount;
+            statistics::Scalar gpfFlushedLines;
+            statistics::Scalar gpfTotalLat;
+            statistics::Formula avgGpfLat;
+            statistics::Scalar dmaDescriptors;
+            statistics::Scalar dmaBytes;
+            statistics::Scalar dmaTotalLat;
+            statistics::Formula avgDmaLat;
+            statistics::Formula dmaBandwidth;
+            statistics::Scalar nmpCommands;
+            statistics::Scalar nmpBytesRead;
+            statistics::Scalar nmpBytesWritten;
+            statistics::Scalar nmpAluCycles;
+            statistics::Scalar nmpTotalLat;
+            statistics::Formula avgNmpLat;
+            statistics::Scalar atomicAccesses;
+            statistics::Scalar atomicLat;
+            statistics::Scalar backdoorsGranted;
         };
     
         CXLCtrlStats stats;
 
     public:
-        Tick read(PacketPtr pkt) override {
-            return cxlRspPort.recvAtomic(pkt);
-        }
-        Tick write(PacketPtr pkt) override {
-            return cxlRspPort.recvAtomic(pkt);
-        }
+        Tick read(PacketPtr pkt) override;
+        Tick write(PacketPtr pkt) override;
+
+        /** Access a control register without side effects. */
+        void accessRegFunctional(PacketPtr pkt);
+
         Port &getPort(const std::string &if_name,
             PortID idx=InvalidPortID) override;
 
@@ -286,6 +438,12 @@ class CXLMemory : public PciDevice
 
         AddrRangeList getAddrRanges() const override;
 
+        void serialize(CheckpointOut &cp) const override;
+        void unserialize(CheckpointIn &cp) override;
+
+        DrainState drain() override;
+        void drainResume() override;
+
         PARAMS(CXLMemory);
         CXLMemory(const Params &p);
 };
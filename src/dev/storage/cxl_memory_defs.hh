@@ -0,0 +1,81 @@
+/* @file
+ * Register descriptions for the control register window of CXLMemory
+ */
+
+#ifndef __DEV_STORAGE_CXL_MEMORY_DEFS_HH__
+#define __DEV_STORAGE_CXL_MEMORY_DEFS_HH__
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace cxl_mem_reg
+{
+
+// Global Persistent Flush registers, 64 bytes starting at 0x00
+const Addr GPF_CTRL         = 0x00; // write 1 to start a GPF
+const Addr GPF_STATUS       = 0x08; // GPF_STATUS_* bits
+const Addr GPF_DIRTY_LINES  = 0x10; // dirty lines in the device buffers
+const Addr GPF_COUNT        = 0x18; // number of GPFs completed
+
+const uint64_t GPF_CTRL_START       = 0x1;
+const uint64_t GPF_STATUS_BUSY      = 0x1;
+const uint64_t GPF_STATUS_PERSISTENT = 0x2;
+
+// DMA engine registers, each channel block is 64 bytes, starting at 0x100
+const Addr DMA_BASE         = 0x100;
+const Addr DMA_CHAN_SIZE    = 0x40;
+
+const Addr DMA_RING_BASE    = 0x00; // address of the descriptor ring
+const Addr DMA_RING_SIZE    = 0x08; // number of descriptors in the ring
+const Addr DMA_HEAD         = 0x10; // doorbell, producer index
+const Addr DMA_TAIL         = 0x18; // consumer index, read-only
+const Addr DMA_STATUS       = 0x20; // DMA_STATUS_* bits, read-only
+const Addr DMA_COMPLETED    = 0x28; // descriptors completed, read-only
+
+const uint64_t DMA_STATUS_BUSY  = 0x1;
+
+/**
+ * Descriptor of one copy in the ring of a DMA channel. Both addresses
+ * are host physical addresses, so a descriptor may move data between
+ * host DRAM and the CXL memory in either direction.
+ */
+struct DmaDesc
+{
+    uint64_t src;
+    uint64_t dest;
+    uint64_t len;
+    uint64_t reserved;
+};
+
+// Near-memory processing (NMP) registers, starting at 0x1000
+const Addr NMP_BASE         = 0x1000;
+const Addr NMP_SIZE         = 0x48;
+
+const Addr NMP_OPCODE       = 0x00; // NMP_OP_*
+const Addr NMP_SRC          = 0x08; // input vector or embedding table
+const Addr NMP_DST          = 0x10; // output vector, 0 for none
+const Addr NMP_COUNT        = 0x18; // number of elements or lookups
+const Addr NMP_ARG0         = 0x20; // filter threshold or index vector
+const Addr NMP_ARG1         = 0x28; // embedding row length in floats
+const Addr NMP_DOORBELL     = 0x30; // write to start the command
+const Addr NMP_STATUS       = 0x38; // NMP_STATUS_* bits, read-only
+const Addr NMP_RESULT       = 0x40; // scalar result, read-only
+
+// Count the uint64_t elements of SRC that are >= ARG0, and compact
+// them into DST if it is set
+const uint64_t NMP_OP_FILTER    = 0x1;
+// Sum the uint64_t elements of SRC
+const uint64_t NMP_OP_REDUCE    = 0x2;
+// Sum-pool the float rows of ARG1 elements of the table at SRC that
+// are selected by the uint64_t indices at ARG0 into DST
+const uint64_t NMP_OP_GATHER    = 0x3;
+
+const uint64_t NMP_STATUS_BUSY  = 0x1;
+const uint64_t NMP_STATUS_ERROR = 0x2;
+
+} // namespace cxl_mem_reg
+} // namespace gem5
+
+#endif // __DEV_STORAGE_CXL_MEMORY_DEFS_HH__
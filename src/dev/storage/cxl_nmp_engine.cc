@@ -0,0 +1,418 @@
+#include "dev/storage/cxl_nmp_engine.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/chunk_generator.hh"
+#include "base/intmath.hh"
+#include "base/trace.hh"
+#include "debug/CXLNmp.hh"
+#include "dev/storage/cxl_memory.hh"
+#include "dev/storage/cxl_memory_defs.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+using namespace cxl_mem_reg;
+
+CXLNmpEngine::CXLNmpEngine(CXLMemory &_cxlMemory, AddrRange cxl_mem_range,
+                           unsigned alu_width, unsigned max_outstanding)
+    : cxlMemory(_cxlMemory), _name(_cxlMemory.name() + ".nmp"),
+      port(_cxlMemory.name() + ".nmp_port", *this),
+      requestorId(_cxlMemory.sys->getRequestorId(&_cxlMemory, "nmp")),
+      cxlMemRange(cxl_mem_range), aluWidth(alu_width),
+      maxOutstanding(max_outstanding),
+      opcode(0), src(0), dst(0), count(0), arg0(0), arg1(0), result(0),
+      busy(false), error(false), cmdStartTick(0), phaseBuf(nullptr),
+      phaseWrite(false), elemSize(0), outstanding(0), retryPkt(nullptr),
+      aluFreeTick(0), atomicLat(0),
+      phaseDoneEvent([this]{
+          // the next step may start another phase and replace nextStep
+          auto next = std::move(nextStep);
+          next();
+      }, name())
+{
+}
+
+uint64_t
+CXLNmpEngine::readReg(Addr offset)
+{
+    switch (offset) {
+      case NMP_OPCODE:
+        return opcode;
+      case NMP_SRC:
+        return src;
+      case NMP_DST:
+        return dst;
+      case NMP_COUNT:
+        return count;
+      case NMP_ARG0:
+        return arg0;
+      case NMP_ARG1:
+        return arg1;
+      case NMP_STATUS:
+        return (busy ? NMP_STATUS_BUSY : 0) | (error ? NMP_STATUS_ERROR : 0);
+      case NMP_RESULT:
+        return result;
+      default:
+        warn("Read from unimplemented NMP register %#x\n", offset);
+        return 0;
+    }
+}
+
+void
+CXLNmpEngine::writeReg(Addr offset, uint64_t val, bool functional)
+{
+    if (busy && offset != NMP_DOORBELL) {
+        warn("%s: register %#x written while busy, ignored\n", name(),
+             offset);
+        return;
+    }
+
+    switch (offset) {
+      case NMP_OPCODE:
+        opcode = val;
+        break;
+      case NMP_SRC:
+        src = val;
+        break;
+      case NMP_DST:
+        dst = val;
+        break;
+      case NMP_COUNT:
+        count = val;
+        break;
+      case NMP_ARG0:
+        arg0 = val;
+        break;
+      case NMP_ARG1:
+        arg1 = val;
+        break;
+      case NMP_DOORBELL:
+        if (functional)
+            break;
+        if (busy) {
+            warn("%s: doorbell rung while busy, ignored\n", name());
+            break;
+        }
+        startCommand();
+        break;
+      default:
+        warn("Write to read-only or unimplemented NMP register %#x\n",
+             offset);
+    }
+}
+
+bool
+CXLNmpEngine::addChunks(Addr addr, uint64_t size, size_t offset)
+{
+    if (size == 0)
+        return true;
+
+    if (size > cxlMemRange.size() || !cxlMemRange.contains(addr) ||
+        !cxlMemRange.contains(addr + size - 1)) {
+        DPRINTF(CXLNmp, "%s: range %#x+%d outside of the CXL memory\n",
+                name(), addr, size);
+        return false;
+    }
+
+    for (ChunkGenerator gen(addr, size, cxlMemory.sys->cacheLineSize());
+         !gen.done(); gen.next()) {
+        pending.push_back({gen.addr(), unsigned(gen.size()),
+                           offset + gen.complete()});
+    }
+    return true;
+}
+
+bool
+CXLNmpEngine::fitsMemory(uint64_t count, uint64_t elem_size) const
+{
+    return elem_size != 0 && count <= cxlMemRange.size() / elem_size;
+}
+
+void
+CXLNmpEngine::startPhase(std::vector<uint8_t> &buf, bool write,
+                         unsigned elem_size, std::function<void()> next)
+{
+    phaseBuf = &buf;
+    phaseWrite = write;
+    elemSize = elem_size;
+    nextStep = next;
+    atomicLat = 0;
+
+    DPRINTF(CXLNmp, "%s: %s phase of %d chunks\n", name(),
+            write ? "write" : "read", pending.size());
+
+    issueChunks();
+    checkPhaseDone();
+}
+
+void
+CXLNmpEngine::issueChunks()
+{
+    bool timing = cxlMemory.sys->isTimingMode();
+
+    while (!retryPkt && outstanding < maxOutstanding && !pending.empty()) {
+        Chunk chunk = pending.front();
+        pending.pop_front();
+
+        RequestPtr req = Request::create(
+            chunk.addr, chunk.size, 0, requestorId);
+        PacketPtr pkt = phaseWrite ? Packet::createWrite(req) :
+                                     Packet::createRead(req);
+        pkt->allocate();
+        if (phaseWrite)
+            pkt->setData(phaseBuf->data() + chunk.offset);
+        pkt->pushSenderState(new NmpSenderState(chunk.offset));
+
+        ++outstanding;
+
+        if (!timing) {
+            atomicLat = std::max(atomicLat, port.sendAtomic(pkt));
+            completeChunk(pkt);
+        } else if (!port.sendTimingReq(pkt)) {
+            retryPkt = pkt;
+        }
+    }
+}
+
+bool
+CXLNmpEngine::NmpPort::recvTimingResp(PacketPtr pkt)
+{
+    engine.completeChunk(pkt);
+    engine.issueChunks();
+    engine.checkPhaseDone();
+    return true;
+}
+
+void
+CXLNmpEngine::NmpPort::recvReqRetry()
+{
+    assert(engine.retryPkt);
+
+    PacketPtr pkt = engine.retryPkt;
+    if (sendTimingReq(pkt)) {
+        engine.retryPkt = nullptr;
+        engine.issueChunks();
+    }
+}
+
+void
+CXLNmpEngine::completeChunk(PacketPtr pkt)
+{
+    auto *state = safe_cast<NmpSenderState *>(pkt->popSenderState());
+    unsigned size = pkt->getSize();
+
+    if (phaseWrite) {
+        cxlMemory.stats.nmpBytesWritten += size;
+    } else {
+        pkt->writeData(phaseBuf->data() + state->offset);
+        cxlMemory.stats.nmpBytesRead += size;
+
+        // the ALU consumes the chunk as soon as both the data and the
+        // ALU are available
+        Cycles cycles(divCeil(size / elemSize, aluWidth));
+        aluFreeTick = std::max(aluFreeTick, curTick()) +
+                      cxlMemory.cyclesToTicks(cycles);
+        cxlMemory.stats.nmpAluCycles += cycles;
+    }
+
+    delete state;
+    delete pkt;
+
+    assert(outstanding > 0);
+    --outstanding;
+}
+
+void
+CXLNmpEngine::checkPhaseDone()
+{
+    if (outstanding || !pending.empty() || phaseDoneEvent.scheduled())
+        return;
+
+    cxlMemory.schedule(phaseDoneEvent,
+                       std::max(curTick() + atomicLat, aluFreeTick));
+}
+
+void
+CXLNmpEngine::startCommand()
+{
+    busy = true;
+    error = false;
+    result = 0;
+    cmdStartTick = curTick();
+    aluFreeTick = curTick();
+
+    DPRINTF(CXLNmp, "%s: opcode %d src %#x dst %#x count %d arg0 %#x "
+            "arg1 %#x\n", name(), opcode, src, dst, count, arg0, arg1);
+
+    if (!port.isConnected()) {
+        warn_once("%s: NMP command without a connected nmp_port\n", name());
+        finishCommand(true);
+        return;
+    }
+
+    // the buffers are sized by the guest, so they are checked against the
+    // CXL memory before anything is allocated
+    if (!fitsMemory(count, sizeof(uint64_t))) {
+        DPRINTF(CXLNmp, "%s: %d elements do not fit in the CXL memory\n",
+                name(), count);
+        finishCommand(true);
+        return;
+    }
+
+    switch (opcode) {
+      case NMP_OP_FILTER:
+        inBuf.resize(count * sizeof(uint64_t));
+        if (!addChunks(src, inBuf.size(), 0))
+            return finishCommand(true);
+        startPhase(inBuf, false, sizeof(uint64_t), [this]{ filterDone(); });
+        break;
+      case NMP_OP_REDUCE:
+        inBuf.resize(count * sizeof(uint64_t));
+        if (!addChunks(src, inBuf.size(), 0))
+            return finishCommand(true);
+        startPhase(inBuf, false, sizeof(uint64_t), [this]{ reduceDone(); });
+        break;
+      case NMP_OP_GATHER:
+        indexBuf.resize(count * sizeof(uint64_t));
+        if (!fitsMemory(arg1, sizeof(float)) ||
+            !addChunks(arg0, indexBuf.size(), 0))
+            return finishCommand(true);
+        startPhase(indexBuf, false, sizeof(uint64_t),
+                   [this]{ gatherIndicesDone(); });
+        break;
+      default:
+        warn("%s: unknown NMP opcode %d\n", name(), opcode);
+        finishCommand(true);
+    }
+}
+
+void
+CXLNmpEngine::filterDone()
+{
+    const uint64_t *elems = reinterpret_cast<uint64_t *>(inBuf.data());
+
+    outBuf.clear();
+    for (uint64_t i = 0; i < count; i++) {
+        if (elems[i] < arg0)
+            continue;
+        ++result;
+        if (dst) {
+            auto *bytes = reinterpret_cast<const uint8_t *>(&elems[i]);
+            outBuf.insert(outBuf.end(), bytes, bytes + sizeof(uint64_t));
+        }
+    }
+
+    if (!addChunks(dst, outBuf.size(), 0))
+        return finishCommand(true);
+    startPhase(outBuf, true, sizeof(uint64_t),
+               [this]{ finishCommand(false); });
+}
+
+void
+CXLNmpEngine::reduceDone()
+{
+    const uint64_t *elems = reinterpret_cast<uint64_t *>(inBuf.data());
+
+    for (uint64_t i = 0; i < count; i++)
+        result += elems[i];
+
+    finishCommand(false);
+}
+
+void
+CXLNmpEngine::gatherIndicesDone()
+{
+    const uint64_t *indices = reinterpret_cast<uint64_t *>(indexBuf.data());
+    const uint64_t row_bytes = arg1 * sizeof(float);
+
+    if (!fitsMemory(count, row_bytes))
+        return finishCommand(true);
+
+    inBuf.resize(count * row_bytes);
+    for (uint64_t i = 0; i < count; i++) {
+        // the row must be in the CXL memory, so any index that would
+        // overflow its offset is out of it
+        if (!fitsMemory(indices[i], row_bytes) ||
+            src + indices[i] * row_bytes < src ||
+            !addChunks(src + indices[i] * row_bytes, row_bytes,
+                       i * row_bytes)) {
+            pending.clear();
+            return finishCommand(true);
+        }
+    }
+    startPhase(inBuf, false, sizeof(float), [this]{ gatherRowsDone(); });
+}
+
+void
+CXLNmpEngine::gatherRowsDone()
+{
+    const float *rows = reinterpret_cast<float *>(inBuf.data());
+
+    std::vector<float> pooled(arg1, 0.0f);
+    for (uint64_t i = 0; i < count; i++) {
+        for (uint64_t j = 0; j < arg1; j++)
+            pooled[j] += rows[i * arg1 + j];
+    }
+    result = count;
+
+    outBuf.resize(arg1 * sizeof(float));
+    std::memcpy(outBuf.data(), pooled.data(), outBuf.size());
+
+    if (!addChunks(dst, dst ? outBuf.size() : 0, 0))
+        return finishCommand(true);
+    startPhase(outBuf, true, sizeof(float),
+               [this]{ finishCommand(false); });
+}
+
+void
+CXLNmpEngine::finishCommand(bool failed)
+{
+    DPRINTF(CXLNmp, "%s: command %s, result %d\n", name(),
+            failed ? "failed" : "done", result);
+
+    busy = false;
+    error = failed;
+
+    cxlMemory.stats.nmpCommands++;
+    cxlMemory.stats.nmpTotalLat += curTick() - cmdStartTick;
+
+    inBuf.clear();
+    indexBuf.clear();
+    outBuf.clear();
+
+    cxlMemory.engineIdle();
+}
+
+void
+CXLNmpEngine::serialize(CheckpointOut &cp) const
+{
+    // the device only drains once the engine is idle
+    assert(!busy);
+
+    SERIALIZE_SCALAR(opcode);
+    SERIALIZE_SCALAR(src);
+    SERIALIZE_SCALAR(dst);
+    SERIALIZE_SCALAR(count);
+    SERIALIZE_SCALAR(arg0);
+    SERIALIZE_SCALAR(arg1);
+    SERIALIZE_SCALAR(result);
+    SERIALIZE_SCALAR(error);
+}
+
+void
+CXLNmpEngine::unserialize(CheckpointIn &cp)
+{
+    UNSERIALIZE_SCALAR(opcode);
+    UNSERIALIZE_SCALAR(src);
+    UNSERIALIZE_SCALAR(dst);
+    UNSERIALIZE_SCALAR(count);
+    UNSERIALIZE_SCALAR(arg0);
+    UNSERIALIZE_SCALAR(arg1);
+    UNSERIALIZE_SCALAR(result);
+    UNSERIALIZE_SCALAR(error);
+}
+
+} // namespace gem5
@@ -0,0 +1,193 @@
+/* @file
+ * Near-memory processing engine of the CXL memory expander
+ */
+
+#ifndef __DEV_STORAGE_CXL_NMP_ENGINE_HH__
+#define __DEV_STORAGE_CXL_NMP_ENGINE_HH__
+
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "mem/request.hh"
+#include "sim/eventq.hh"
+#include "sim/serialize.hh"
+
+namespace gem5
+{
+
+class CXLMemory;
+
+/**
+ * A near-memory processing unit inside CXLMemory. The host programs a
+ * command through the NMP registers of the device control window and
+ * rings the doorbell; the engine then streams its operands from the
+ * back-end memory media through its own port on the device side of
+ * the CXL link, processes them with an ALU of a configurable width,
+ * and writes vector results back to the media. Only the doorbell and
+ * the scalar result cross the host link.
+ *
+ * A command runs as a sequence of phases, each of which either reads
+ * a set of address chunks into a staging buffer or writes a buffer
+ * out. Timing is modelled per chunk, while the functional result is
+ * computed on the staged data at the end of the phase.
+ */
+class CXLNmpEngine : public Serializable
+{
+  private:
+    /** Port on the device side of the link to the back-end media. */
+    class NmpPort : public RequestPort
+    {
+      private:
+        CXLNmpEngine &engine;
+
+      public:
+        NmpPort(const std::string &_name, CXLNmpEngine &_engine)
+            : RequestPort(_name), engine(_engine)
+        { }
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvReqRetry() override;
+    };
+
+    /** Remembers where the data of a read chunk goes. */
+    struct NmpSenderState : public Packet::SenderState
+    {
+        const size_t offset;
+        NmpSenderState(size_t _offset) : offset(_offset) { }
+    };
+
+    /** A chunk of a phase, at an offset in the phase buffer. */
+    struct Chunk
+    {
+        Addr addr;
+        unsigned size;
+        size_t offset;
+    };
+
+    /** The device this engine belongs to. */
+    CXLMemory &cxlMemory;
+
+    const std::string _name;
+
+    NmpPort port;
+
+    /** Requestor id of the engine's memory accesses. */
+    RequestorID requestorId;
+
+    /** Range of the CXL memory the operands must be located in. */
+    const AddrRange cxlMemRange;
+
+    /** Elements the ALU processes per device cycle. */
+    const unsigned aluWidth;
+
+    /** Maximum number of memory accesses in flight. */
+    const unsigned maxOutstanding;
+
+    /** Host visible registers. */
+    uint64_t opcode;
+    Addr src;
+    Addr dst;
+    uint64_t count;
+    uint64_t arg0;
+    uint64_t arg1;
+    uint64_t result;
+    bool busy;
+    bool error;
+
+    /** When did the current command start. */
+    Tick cmdStartTick;
+
+    /** Chunks of the current phase still to be issued. */
+    std::deque<Chunk> pending;
+
+    /** Buffer the current phase reads into or writes from. */
+    std::vector<uint8_t> *phaseBuf;
+
+    /** Is the current phase writing. */
+    bool phaseWrite;
+
+    /** Size in bytes of the elements the ALU processes this phase. */
+    unsigned elemSize;
+
+    /** Memory accesses issued and not yet completed. */
+    unsigned outstanding;
+
+    /** Packet that was refused by the memory side. */
+    PacketPtr retryPkt;
+
+    /** Tick at which the ALU is done with the data received so far. */
+    Tick aluFreeTick;
+
+    /** Longest access latency seen in the current atomic phase. */
+    Tick atomicLat;
+
+    /** Staging buffers for operands and results. */
+    std::vector<uint8_t> inBuf;
+    std::vector<uint8_t> indexBuf;
+    std::vector<uint8_t> outBuf;
+
+    /** What to do once the current phase is complete. */
+    std::function<void()> nextStep;
+
+    EventFunctionWrapper phaseDoneEvent;
+
+    /**
+     * Split a range of memory into chunks of the current phase.
+     *
+     * @return false if the range is not in the CXL memory
+     */
+    bool addChunks(Addr addr, uint64_t size, size_t offset);
+
+    /**
+     * Whether count elements of elem_size bytes, as written by the guest,
+     * fit in the CXL memory, without overflowing their size.
+     */
+    bool fitsMemory(uint64_t count, uint64_t elem_size) const;
+
+    /** Start a phase with the chunks added so far. */
+    void startPhase(std::vector<uint8_t> &buf, bool write,
+                    unsigned elem_size, std::function<void()> next);
+
+    void issueChunks();
+    void completeChunk(PacketPtr pkt);
+    void checkPhaseDone();
+
+    /** Command steps. */
+    void startCommand();
+    void filterDone();
+    void reduceDone();
+    void gatherIndicesDone();
+    void gatherRowsDone();
+    void finishCommand(bool failed);
+
+  public:
+    CXLNmpEngine(CXLMemory &_cxlMemory, AddrRange cxl_mem_range,
+                 unsigned alu_width, unsigned max_outstanding);
+
+    const std::string &name() const { return _name; }
+
+    Port &getPort() { return port; }
+
+    /**
+     * Access a register of the NMP block. A functional write to the
+     * doorbell does not start a command.
+     */
+    uint64_t readReg(Addr offset);
+    void writeReg(Addr offset, uint64_t val, bool functional);
+
+    bool isBusy() const { return busy; }
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+};
+
+} // namespace gem5
+
+#endif // __DEV_STORAGE_CXL_NMP_ENGINE_HH__
@@ -102,7 +102,9 @@ class SouthBridge(SimObject):
         self.cmos.pio = bus.mem_side_ports
         self.dma1.pio = bus.mem_side_ports
         self.ide.pio = bus.mem_side_ports
-        self.cxlmemory.cxl_rsp_port = bus.mem_side_ports
+        # unless the board has put the device behind its own bridge
+        if self.cxlmemory.cxl_rsp_port.peer is None:
+            self.cxlmemory.cxl_rsp_port = bus.mem_side_ports
         if dma_ports.count(self.ide.dma) == 0:
             self.ide.dma = bus.cpu_side_ports
         if dma_ports.count(self.cxlmemory.dma) == 0:
@@ -64,6 +64,18 @@ class AbstractMemory(ClockedObject):
     # are not accessible by the CPU.
     kvm_map = Param.Bool(True, "Should KVM map this memory for the guest")
 
+    # Very large memories, such as CXL memory pools, may only be touched
+    # sparsely. Their backing store then only takes host memory for the
+    # pages written, while untouched pages read as the host zero page.
+    sparse_backing = Param.Bool(
+        False, "Only back the written pages of this memory with host memory"
+    )
+    dedup_backing = Param.Bool(
+        False,
+        "Let the host merge identical pages of the sparse backing store "
+        "(Linux KSM, which must be enabled on the host)",
+    )
+
     # Should the bootloader include this memory when passing
     # configuration information about the physical memory layout to
     # the kernel, e.g. using ATAG or ACPI
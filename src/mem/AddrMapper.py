@@ -83,3 +83,26 @@ class RangeAddrMapper(AddrMapper):
     remapped_ranges = VectorParam.AddrRange(
         "Ranges of memory that are being mapped to"
     )
+
+
+# Weighted interleave address mapper that stripes one range across a set
+# of targets, e.g. local DRAM and a CXL memory, with a configurable weight
+# per target, like the weighted interleave memory policy of Linux does
+# across NUMA nodes. The stripes of each target are packed into its
+# remapped range, so the memory side of the mapper should be a crossbar
+# routing each remapped range to its target.
+class WeightedInterleaveAddrMapper(AddrMapper):
+    type = "WeightedInterleaveAddrMapper"
+    cxx_header = "mem/addr_mapper.hh"
+    cxx_class = "gem5::WeightedInterleaveAddrMapper"
+
+    interleaved_range = Param.AddrRange(
+        "Range of memory that is striped across the targets"
+    )
+    remapped_ranges = VectorParam.AddrRange(
+        "Ranges the stripes of each target are mapped to"
+    )
+    weights = VectorParam.Unsigned(
+        "Number of consecutive stripes mapped to each target in turn"
+    )
+    granularity = Param.MemorySize("4KiB", "Size of a stripe")
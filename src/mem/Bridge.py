@@ -38,6 +38,7 @@
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.params import *
+from m5.proxy import *
 
 
 class Bridge(ClockedObject):
@@ -87,6 +88,19 @@ class CXLBridge(ClockedObject):
     resp_fifo_depth = Param.Unsigned(48, "The number of responses to buffer")
     bridge_lat = Param.Latency("50ns", "The latency of this bridge")
     proto_proc_lat = Param.Latency("14ns", "Conversion latency of cxl protocol in bridge")
+
+    # Link errors and link layer retry (LLR) on the CXL link
+    link_ber = Param.Float(0.0, "Bit error rate of the CXL link, 0 disables error injection")
+    flit_size = Param.Unsigned(68, "Size of a CXL link flit in bytes")
+    flit_lat = Param.Latency("1ns", "Time to transmit one flit on the CXL link")
+    llr_replay_lat = Param.Latency("30ns", "Latency from a CRC error to the start of the replay")
+    llr_buf_size = Param.Unsigned(128, "Number of flits held by the link layer retry buffer")
+
+    # Event queue of everything behind the CXL link. When it differs
+    # from eventq_index the two sides are simulated by separate threads
+    # and bridge_lat is the lookahead, so sim_quantum must not exceed it.
+    mem_side_eventq_index = Param.UInt32(Self.eventq_index, "Event queue of the mem side port")
+    system = Param.System(Parent.any, "System the bridge is part of")
     ranges = VectorParam.AddrRange(
         [AllMemory], "Address ranges to pass through the bridge"
     )
@@ -63,7 +63,8 @@ AbstractMemory::AbstractMemory(const Params &p) :
                  MemBackdoor::Readable | MemBackdoor::Writeable :
                  MemBackdoor::Readable)),
     confTableReported(p.conf_table_reported), inAddrMap(p.in_addr_map),
-    kvmMap(p.kvm_map), writeable(p.writeable), _system(NULL),
+    kvmMap(p.kvm_map), sparseBacking(p.sparse_backing),
+    dedupBacking(p.dedup_backing), writeable(p.writeable), _system(NULL),
     stats(*this)
 {
     panic_if(!range.valid() || !range.size(),
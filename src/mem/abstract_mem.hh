@@ -129,6 +129,12 @@ class AbstractMemory : public ClockedObject
     // Should KVM map this memory for the guest
     const bool kvmMap;
 
+    // Should the backing store only take host memory where written
+    const bool sparseBacking;
+
+    // Should the host merge identical pages of the backing store
+    const bool dedupBacking;
+
     // Are writes allowed to this memory
     const bool writeable;
 
@@ -338,6 +344,19 @@ class AbstractMemory : public ClockedObject
      */
     bool isKvmMap() const { return kvmMap; }
 
+    /**
+     * Very large memories may only be backed by host memory where they
+     * are written.
+     *
+     * @return if the backing store of this memory is sparse
+     */
+    bool isSparseBacking() const { return sparseBacking; }
+
+    /**
+     * @return if the host may merge identical pages of the backing store
+     */
+    bool isDedupBacking() const { return dedupBacking; }
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
@@ -37,6 +37,11 @@
 
 #include "mem/addr_mapper.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
 namespace gem5
 {
 
@@ -274,4 +279,63 @@ RangeAddrMapper::getAddrRanges() const
     return ranges;
 }
 
+namespace
+{
+
+memory::WeightedInterleave
+makeInterleave(const WeightedInterleaveAddrMapperParams &p)
+{
+    fatal_if(p.weights.size() != p.remapped_ranges.size(),
+             "%s: there must be one weight per remapped range\n", p.name);
+    fatal_if(std::all_of(p.weights.begin(), p.weights.end(),
+                         [](unsigned weight) { return weight == 0; }),
+             "%s: at least one weight must be non-zero\n", p.name);
+    fatal_if(!isPowerOf2(p.granularity) || p.granularity < 64,
+             "%s: the granularity must be a power of two of at least 64 "
+             "bytes\n", p.name);
+    return memory::WeightedInterleave(p.weights, p.granularity);
+}
+
+} // anonymous namespace
+
+WeightedInterleaveAddrMapper::WeightedInterleaveAddrMapper(
+        const WeightedInterleaveAddrMapperParams &p) :
+    AddrMapper(p),
+    interleavedRange(p.interleaved_range),
+    remappedRanges(p.remapped_ranges),
+    interleave(makeInterleave(p))
+{
+    fatal_if(interleavedRange.interleaved(),
+             "%s: the interleaved range may not itself be interleaved\n",
+             name());
+    fatal_if(interleavedRange.size() % interleave.roundBytes() != 0,
+             "%s: the size of %s is not a multiple of the %#x bytes of a "
+             "round of stripes\n", name(), interleavedRange.to_string(),
+             interleave.roundBytes());
+
+    for (unsigned i = 0; i < remappedRanges.size(); ++i) {
+        fatal_if(remappedRanges[i].size() <
+                 interleave.targetBytes(i, interleavedRange.size()),
+                 "%s: %s is too small for the %#x bytes interleaved to it\n",
+                 name(), remappedRanges[i].to_string(),
+                 interleave.targetBytes(i, interleavedRange.size()));
+    }
+}
+
+Addr
+WeightedInterleaveAddrMapper::remapAddr(Addr addr) const
+{
+    if (!interleavedRange.contains(addr))
+        return addr;
+
+    auto location = interleave.map(addr - interleavedRange.start());
+    return remappedRanges[location.target].start() + location.offset;
+}
+
+AddrRangeList
+WeightedInterleaveAddrMapper::getAddrRanges() const
+{
+    return {interleavedRange};
+}
+
 } // namespace gem5
@@ -43,8 +43,10 @@
 #include "mem/backdoor_manager.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
+#include "mem/weighted_interleave.hh"
 #include "params/AddrMapper.hh"
 #include "params/RangeAddrMapper.hh"
+#include "params/WeightedInterleaveAddrMapper.hh"
 #include "sim/sim_object.hh"
 
 namespace gem5
@@ -239,8 +241,8 @@ class AddrMapper : public SimObject
 
     void recvFunctionalSnoop(PacketPtr pkt);
 
-    void recvMemBackdoorReq(const MemBackdoorReq &req,
-                            MemBackdoorPtr &backdoor);
+    virtual void recvMemBackdoorReq(const MemBackdoorReq &req,
+                                    MemBackdoorPtr &backdoor);
 
     Tick recvAtomic(PacketPtr pkt);
 
@@ -319,6 +321,63 @@ class RangeAddrMapper : public AddrMapper
     BackdoorManager backdoorManager;
 };
 
+/**
+ * Weighted interleave address mapper that stripes one range across a set
+ * of targets, e.g. local DRAM and a CXL memory, in proportion to their
+ * weights. Each target receives its stripes packed contiguously in its
+ * remapped range, which the memory side of the mapper has to route to
+ * it, typically through a crossbar. Stripes are at least as large as a
+ * cache line, so that no access straddles two targets.
+ *
+ * As the stripes of a target are not contiguous in the interleaved
+ * range, no backdoors are handed out through the mapper.
+ */
+class WeightedInterleaveAddrMapper : public AddrMapper
+{
+  public:
+    WeightedInterleaveAddrMapper(
+        const WeightedInterleaveAddrMapperParams &p);
+
+    AddrRangeList getAddrRanges() const override;
+
+    void
+    init() override
+    {
+        AddrMapper::init();
+        cpuSidePort.sendRangeChange();
+    }
+
+  protected:
+    /** The range striped across the targets. */
+    const AddrRange interleavedRange;
+
+    /** Ranges the stripes of each target are packed into. */
+    const std::vector<AddrRange> remappedRanges;
+
+    const memory::WeightedInterleave interleave;
+
+    Addr remapAddr(Addr addr) const override;
+
+    void
+    recvMemBackdoorReq(const MemBackdoorReq &req,
+                       MemBackdoorPtr &backdoor) override
+    {
+        backdoor = nullptr;
+    }
+
+    MemBackdoorPtr
+    getRevertedBackdoor(MemBackdoorPtr &backdoor,
+                        const AddrRange &range) override
+    {
+        return nullptr;
+    }
+
+    void
+    recvRangeChange() override
+    {
+    }
+};
+
 } // namespace gem5
 
 #endif //__MEM_ADDR_MAPPER_HH__
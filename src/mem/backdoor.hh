@@ -34,6 +34,7 @@
 
 #include "base/addr_range.hh"
 #include "base/callback.hh"
+#include "base/types.hh"
 
 namespace gem5
 {
@@ -89,6 +90,11 @@ class MemBackdoor
     Flags flags() const { return _flags; }
     void flags(Flags f) { _flags = f; }
 
+    // The latency holders should account for each access through this
+    // back door, for targets the back door skips the timing of.
+    Tick latency() const { return _latency; }
+    void latency(Tick l) { _latency = l; }
+
     MemBackdoor(AddrRange r, uint8_t *p, Flags flags) :
         _range(r), _ptr(p), _flags(flags)
     {}
@@ -122,6 +128,7 @@ class MemBackdoor
     AddrRange _range;
     uint8_t *_ptr;
     Flags _flags;
+    Tick _latency = 0;
 };
 
 typedef MemBackdoor *MemBackdoorPtr;
@@ -2,6 +2,7 @@
 // enabling artificial delay injection and timed forwarding behavior.
 
 #include "mem/cache/CXLCacheBridge.hh"
+#include "base/binary_trace.hh"
 #include "mem/packet.hh"
 #include "debug/CXLCacheBridge.hh"
 
@@ -11,6 +12,7 @@ CXLCacheBridge::CXLCacheBridge(const CXLCacheBridgeParams &p)
     : ClockedObject(p),
       cpuSidePort(name() + ".cpu_side_port", *this),
       memSidePort(name() + ".mem_side_port", *this),
+      traceId(binary_trace::objectId(name())),
       waitingResp(false),
       waitingReq(false)
 {
@@ -34,8 +36,8 @@ AddrRangeList CXLCacheBridge::getAddrRanges() const
 
 bool CXLCacheBridge::CPUSidePort::recvTimingReq(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Host timing request | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, bridge.traceId, "hostTimingReq", pkt->getAddr(),
+           pkt->cmdToIndex(), 0);
     if (!bridge.sendToDevice(pkt)) {
         bridge.hostToDeviceQueue.push_back(pkt);
         bridge.waitingReq = true;
@@ -46,23 +48,24 @@ bool CXLCacheBridge::CPUSidePort::recvTimingReq(PacketPtr pkt)
 
 bool CXLCacheBridge::CPUSidePort::recvTimingSnoopReq(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Received timing snoop req | Addr: %#x\n", pkt->getAddr());
+    BTRACE(CXLCacheBridge, bridge.traceId, "hostTimingSnoopReq",
+           pkt->getAddr(), pkt->cmdToIndex(), 0);
     bridge.handleHostSnoop(pkt);
     return true;
 }
 
 bool CXLCacheBridge::CPUSidePort::recvTimingResp(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Host response from memory → Device | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, bridge.traceId, "hostTimingResp", pkt->getAddr(),
+           pkt->cmdToIndex(), 0);
     bridge.memSidePort.sendTimingResp(pkt);
     return true;
 }
 
 bool CXLCacheBridge::MemSidePort::recvTimingReq(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Device request → Host | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, bridge.traceId, "deviceTimingReq", pkt->getAddr(),
+           pkt->cmdToIndex(), 0);
     if (!bridge.cpuSidePort.sendTimingReq(pkt)) {
         bridge.deviceToHostQueue.push_back(pkt);
         bridge.waitingResp = true;
@@ -73,8 +76,8 @@ bool CXLCacheBridge::MemSidePort::recvTimingReq(PacketPtr pkt)
 
 bool CXLCacheBridge::MemSidePort::recvTimingResp(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Device response → Host | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, bridge.traceId, "deviceTimingResp",
+           pkt->getAddr(), pkt->cmdToIndex(), 0);
     bridge.handleDeviceResponse(pkt);
     return true;
 }
@@ -129,8 +132,8 @@ bool CXLCacheBridge::sendToDevice(PacketPtr pkt)
 
 void CXLCacheBridge::translateToDevice(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Host → Device | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, traceId, "toDevice", pkt->getAddr(),
+           pkt->cmdToIndex(), 0);
 
     switch (pkt->cmd) {
         case MemCmd::ReadReq:
@@ -151,7 +154,7 @@ void CXLCacheBridge::translateToDevice(PacketPtr pkt)
             pkt->cmd = MemCmd::Go;
             break;
         default:
-            DPRINTF(CXLBridge, "[CXLBridge] Warning: Unhandled translation Host → Device: %s\n",
+            DPRINTF(CXLCacheBridge, "[CXLBridge] Warning: Unhandled translation Host → Device: %s\n",
                     pkt->cmd.toString().c_str());
             break;
     }
@@ -161,8 +164,8 @@ void CXLCacheBridge::translateToDevice(PacketPtr pkt)
 
 void CXLCacheBridge::translateToHost(PacketPtr pkt)
 {
-    DPRINTF(CXLBridge, "[CXLBridge] Device → Host | Addr: %#x | Cmd: %s\n",
-            pkt->getAddr(), pkt->cmd.toString().c_str());
+    BTRACE(CXLCacheBridge, traceId, "toHost", pkt->getAddr(),
+           pkt->cmdToIndex(), 0);
 
     switch (pkt->cmd) {
         case MemCmd::WritebackDirty:
@@ -177,7 +180,7 @@ void CXLCacheBridge::translateToHost(PacketPtr pkt)
             pkt->cmd = MemCmd::Go;
             break;
         default:
-            DPRINTF(CXLBridge, "[CXLBridge] Warning: Unhandled translation Device → Host: %s\n",
+            DPRINTF(CXLCacheBridge, "[CXLBridge] Warning: Unhandled translation Device → Host: %s\n",
                     pkt->cmd.toString().c_str());
             break;
     }
@@ -58,6 +58,9 @@ class CXLCacheBridge : public ClockedObject
     CPUSidePort cpuSidePort;
     MemSidePort memSidePort;
 
+    /** Id of the bridge in binary traces. */
+    const uint32_t traceId;
+
     static std::deque<PacketPtr> hostToDeviceQueue;
     static std::deque<PacketPtr> deviceToHostQueue;
     static bool waitingReq;
@@ -94,6 +94,13 @@ class BaseSetAssoc(BaseTags):
         Parent.replacement_policy, "Replacement policy"
     )
 
+    # Keep a contiguous copy of the tags of each set and compare them
+    # with SIMD instructions, which pays off for wide caches. Requires a
+    # SetAssociative indexing policy and at most 64 ways.
+    vector_tag_lookup = Param.Bool(
+        False, "Look tags up in a vectorized tag array"
+    )
+
 
 class SectorTags(BaseTags):
     type = "SectorTags"
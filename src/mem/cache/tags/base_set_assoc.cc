@@ -47,7 +47,9 @@
 
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
 
 namespace gem5
 {
@@ -55,7 +57,9 @@ namespace gem5
 BaseSetAssoc::BaseSetAssoc(const Params &p)
     :BaseTags(p), allocAssoc(p.assoc), blks(p.size / p.block_size),
      sequentialAccess(p.sequential_access),
-     replacementPolicy(p.replacement_policy)
+     replacementPolicy(p.replacement_policy), assoc(p.assoc),
+     vectorTagLookup(p.vector_tag_lookup), setIndexing(nullptr),
+     tagMatch(nullptr)
 {
     // There must be a indexing policy
     fatal_if(!p.indexing_policy, "An indexing policy is required");
@@ -64,6 +68,20 @@ BaseSetAssoc::BaseSetAssoc(const Params &p)
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+
+    if (vectorTagLookup) {
+        setIndexing = dynamic_cast<SetAssociative *>(p.indexing_policy);
+        fatal_if(!setIndexing, "%s: vector_tag_lookup requires a "
+                 "SetAssociative indexing policy\n", name());
+        fatal_if(assoc > 64, "%s: vector_tag_lookup supports at most 64 "
+                 "ways\n", name());
+
+        const size_t num_sets = numBlocks / assoc;
+        tagArray.resize(numBlocks, 0);
+        validWays.resize(num_sets, 0);
+        secureWays.resize(num_sets, 0);
+        tagMatch = tag_match::best();
+    }
 }
 
 void
@@ -85,10 +103,51 @@ BaseSetAssoc::tagsInit()
     }
 }
 
+void
+BaseSetAssoc::updateTagArray(const CacheBlk *blk)
+{
+    if (!vectorTagLookup)
+        return;
+
+    const uint32_t set = blk->getSet();
+    const uint64_t way_bit = 1ULL << blk->getWay();
+
+    tagArray[set * assoc + blk->getWay()] = blk->getTag();
+    if (blk->isValid())
+        validWays[set] |= way_bit;
+    else
+        validWays[set] &= ~way_bit;
+    if (blk->isSecure())
+        secureWays[set] |= way_bit;
+    else
+        secureWays[set] &= ~way_bit;
+}
+
+CacheBlk*
+BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    if (!vectorTagLookup)
+        return BaseTags::findBlock(addr, is_secure);
+
+    const uint32_t set = setIndexing->getSetIndex(addr);
+    const Addr tag = extractTag(addr);
+
+    uint64_t ways = tagMatch(&tagArray[set * assoc], assoc, tag) &
+        validWays[set] & (is_secure ? secureWays[set] : ~secureWays[set]);
+    if (!ways)
+        return nullptr;
+
+    CacheBlk *blk = static_cast<CacheBlk*>(
+        indexingPolicy->getEntry(set, ctz64(ways)));
+    assert(blk->matchTag(tag, is_secure));
+    return blk;
+}
+
 void
 BaseSetAssoc::invalidate(CacheBlk *blk)
 {
     BaseTags::invalidate(blk);
+    updateTagArray(blk);
 
     // Decrease the number of tags in use
     stats.tagsInUse--;
@@ -101,6 +160,8 @@ void
 BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
 {
     BaseTags::moveBlock(src_blk, dest_blk);
+    updateTagArray(src_blk);
+    updateTagArray(dest_blk);
 
     // Since the blocks were using different replacement data pointers,
     // we must touch the replacement data of the new entry, and invalidate
@@ -59,12 +59,15 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/tag_match.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
 namespace gem5
 {
 
+class SetAssociative;
+
 /**
  * A basic cache tag store.
  * @sa  \ref gem5MemorySystem "gem5 Memory System"
@@ -87,6 +90,30 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
+    /** Whether lookups use the vectorized tag array. */
+    const bool vectorTagLookup;
+
+    /**
+     * Structure-of-arrays copy of the tags used by vectorTagLookup. The
+     * tags of the ways of a set are contiguous, and each set has a bit
+     * per way in validWays and secureWays.
+     */
+    std::vector<Addr> tagArray;
+    std::vector<uint64_t> validWays;
+    std::vector<uint64_t> secureWays;
+
+    /** The indexing policy, if vectorTagLookup is set. */
+    SetAssociative *setIndexing;
+
+    /** Tag comparison used by vectorTagLookup. */
+    tag_match::MatchFn tagMatch;
+
+    /** Bring the tag array entry of a block up to date. */
+    void updateTagArray(const CacheBlk *blk);
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -106,6 +133,15 @@ class BaseSetAssoc : public BaseTags
      */
     void tagsInit() override;
 
+    /**
+     * Find a block, through the tag array if vectorTagLookup is set.
+     *
+     * @param addr The address to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block.
+     */
+    CacheBlk *findBlock(Addr addr, bool is_secure) const override;
+
     /**
      * This function updates the tags when a block is invalidated. It also
      * updates the replacement data.
@@ -193,6 +229,7 @@ class BaseSetAssoc : public BaseTags
     {
         // Insert block
         BaseTags::insertBlock(pkt, blk);
+        updateTagArray(blk);
 
         // Increment tag counter
         stats.tagsInUse++;
@@ -106,6 +106,14 @@ class SetAssociative : public BaseIndexingPolicy
      */
     ~SetAssociative() {};
 
+    /**
+     * Get the set an address maps to.
+     *
+     * @param addr The address to calculate the set for.
+     * @return The set index.
+     */
+    uint32_t getSetIndex(const Addr addr) const { return extractSet(addr); }
+
     /**
      * Find all possible entries for insertion and replacement of an address.
      * Should be called immediately before ReplacementPolicy's findVictim()
@@ -0,0 +1,98 @@
+#include "mem/cache/tags/tag_match.hh"
+
+#include <cassert>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define TAG_MATCH_X86 1
+#endif
+
+namespace gem5
+{
+
+namespace tag_match
+{
+
+uint64_t
+matchScalar(const Addr *tags, unsigned count, Addr tag)
+{
+    assert(count <= 64);
+
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < count; i++)
+        mask |= uint64_t(tags[i] == tag) << i;
+    return mask;
+}
+
+#ifdef TAG_MATCH_X86
+
+namespace
+{
+
+// These are built for the instruction set they use regardless of the
+// flags of the rest of the simulator, and only called if the host
+// supports it.
+
+__attribute__((target("sse4.1"))) uint64_t
+matchSse41(const Addr *tags, unsigned count, Addr tag)
+{
+    assert(count <= 64);
+
+    const __m128i key = _mm_set1_epi64x(tag);
+    uint64_t mask = 0;
+    unsigned i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i ways = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(tags + i));
+        __m128i eq = _mm_cmpeq_epi64(ways, key);
+        mask |= uint64_t(_mm_movemask_pd(_mm_castsi128_pd(eq))) << i;
+    }
+    for (; i < count; i++)
+        mask |= uint64_t(tags[i] == tag) << i;
+    return mask;
+}
+
+__attribute__((target("avx2"))) uint64_t
+matchAvx2(const Addr *tags, unsigned count, Addr tag)
+{
+    assert(count <= 64);
+
+    const __m256i key = _mm256_set1_epi64x(tag);
+    uint64_t mask = 0;
+    unsigned i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i ways = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(tags + i));
+        __m256i eq = _mm256_cmpeq_epi64(ways, key);
+        mask |= uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) << i;
+    }
+    for (; i < count; i++)
+        mask |= uint64_t(tags[i] == tag) << i;
+    return mask;
+}
+
+} // anonymous namespace
+
+#endif // TAG_MATCH_X86
+
+std::vector<Impl>
+available()
+{
+    std::vector<Impl> impls = {{"scalar", matchScalar}};
+#ifdef TAG_MATCH_X86
+    if (__builtin_cpu_supports("sse4.1"))
+        impls.push_back({"sse4.1", matchSse41});
+    if (__builtin_cpu_supports("avx2"))
+        impls.push_back({"avx2", matchAvx2});
+#endif
+    return impls;
+}
+
+MatchFn
+best()
+{
+    return available().back().fn;
+}
+
+} // namespace tag_match
+} // namespace gem5
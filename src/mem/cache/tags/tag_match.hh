@@ -0,0 +1,47 @@
+/* @file
+ * Vectorized comparison of the tags of a cache set
+ */
+
+#ifndef __MEM_CACHE_TAGS_TAG_MATCH_HH__
+#define __MEM_CACHE_TAGS_TAG_MATCH_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace tag_match
+{
+
+/**
+ * Compare the contiguous tags of up to 64 ways against a tag.
+ *
+ * @param tags The tags, one per way.
+ * @param count The number of ways, at most 64.
+ * @param tag The tag to look for.
+ * @return A mask with bit i set if tags[i] equals tag.
+ */
+typedef uint64_t (*MatchFn)(const Addr *tags, unsigned count, Addr tag);
+
+/** Portable implementation, which the compiler may auto-vectorize. */
+uint64_t matchScalar(const Addr *tags, unsigned count, Addr tag);
+
+struct Impl
+{
+    const char *name;
+    MatchFn fn;
+};
+
+/** The implementations the host can run, the best one last. */
+std::vector<Impl> available();
+
+/** The best implementation for the host. */
+MatchFn best();
+
+} // namespace tag_match
+} // namespace gem5
+
+#endif // __MEM_CACHE_TAGS_TAG_MATCH_HH__
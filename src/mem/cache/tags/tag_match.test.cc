@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "mem/cache/tags/tag_match.hh"
+
+using namespace gem5;
+
+/** All implementations agree with the scalar one for any way count. */
+TEST(TagMatchTest, ImplementationsAgree)
+{
+    std::mt19937_64 rng(5);
+    std::vector<Addr> tags(64);
+
+    for (const auto &impl : tag_match::available()) {
+        for (unsigned count = 0; count <= 64; count++) {
+            for (int iter = 0; iter < 20; iter++) {
+                // a small tag space so that there are multiple matches
+                for (auto &tag : tags)
+                    tag = rng() % 8;
+                Addr tag = rng() % 8;
+                EXPECT_EQ(impl.fn(tags.data(), count, tag),
+                          tag_match::matchScalar(tags.data(), count, tag))
+                    << impl.name << " with " << count << " ways";
+            }
+        }
+    }
+}
+
+/** Tags that only differ in the upper bits do not match. */
+TEST(TagMatchTest, FullWidthCompare)
+{
+    std::vector<Addr> tags(48, 0x1234);
+    tags[7] = 0x1234 | (1ULL << 63);
+    tags[40] = 0x1234 | (1ULL << 32);
+    for (const auto &impl : tag_match::available()) {
+        EXPECT_EQ(impl.fn(tags.data(), 48, 0x1234),
+                  ((1ULL << 48) - 1) & ~(1ULL << 7) & ~(1ULL << 40))
+            << impl.name;
+    }
+}
+
+namespace
+{
+
+/** Stand-in for a cache block, about the size of a CacheBlk. */
+struct Block
+{
+    Addr tag;
+    bool valid;
+    bool secure;
+    uint8_t other[128];
+};
+
+} // anonymous namespace
+
+/**
+ * Lookups per second in the sets of a 96MB 48-way cache, walking the
+ * blocks of a set through a vector of pointers as BaseTags does, and
+ * with each of the tag array implementations. This is a benchmark
+ * rather than a test; run it with --gtest_also_run_disabled_tests.
+ */
+TEST(TagMatchTest, DISABLED_WideSetThroughput)
+{
+    const unsigned assoc = 48;
+    const unsigned num_sets = (96 << 20) / 64 / assoc;
+    const unsigned lookups = 2000000;
+
+    std::mt19937_64 rng(11);
+    std::vector<Addr> tags(size_t(num_sets) * assoc);
+    for (auto &tag : tags)
+        tag = rng() >> 20;
+
+    std::vector<Block> blocks(tags.size());
+    std::vector<std::vector<Block *>> sets(num_sets);
+    for (size_t i = 0; i < blocks.size(); i++) {
+        blocks[i].tag = tags[i];
+        blocks[i].valid = true;
+        blocks[i].secure = false;
+        sets[i / assoc].push_back(&blocks[i]);
+    }
+
+    {
+        uint64_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < lookups; i++) {
+            unsigned set = (i * 2654435761u) % num_sets;
+            // copied, as getPossibleEntries() returns the set by value
+            const std::vector<Block *> entries = sets[set];
+            Addr tag = tags[size_t(set) * assoc + i % assoc];
+            for (const Block *blk : entries) {
+                if (blk->valid && blk->tag == tag && !blk->secure) {
+                    ++hits;
+                    break;
+                }
+            }
+        }
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(hits, lookups);
+
+        std::cout << "blocks: " << lookups / secs.count()
+                  << " lookups/s\n";
+    }
+
+    for (const auto &impl : tag_match::available()) {
+        uint64_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < lookups; i++) {
+            unsigned set = (i * 2654435761u) % num_sets;
+            const Addr *set_tags = &tags[size_t(set) * assoc];
+            hits += impl.fn(set_tags, assoc, set_tags[i % assoc]) != 0;
+        }
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(hits, lookups);
+
+        std::cout << impl.name << ": " << lookups / secs.count()
+                  << " lookups/s\n";
+    }
+}
@@ -0,0 +1,279 @@
+#include "mem/chunked_store.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/host_pages.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+namespace chunked_store
+{
+
+namespace
+{
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t pageBytes;
+    uint32_t chunkPages;
+    uint32_t reserved;
+    uint64_t size;
+    uint64_t numChunks;
+};
+
+const char magic[8] = {'g', 'e', 'm', '5', 'c', 'h', 'k', '\0'};
+
+bool
+allZero(const uint8_t *data, uint64_t bytes)
+{
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(data);
+    const uint64_t num_words = bytes / sizeof(uint64_t);
+
+    // or blocks of words together, so the compiler can vectorize the
+    // inner loop, and only branch once per block
+    uint64_t i = 0;
+    for (; i + 8 <= num_words; i += 8) {
+        uint64_t acc = 0;
+        for (unsigned j = 0; j < 8; j++)
+            acc |= words[i + j];
+        if (acc)
+            return false;
+    }
+    for (uint64_t b = i * sizeof(uint64_t); b < bytes; b++) {
+        if (data[b])
+            return false;
+    }
+    return true;
+}
+
+void
+writeAll(int fd, const void *data, uint64_t bytes, uint64_t offset,
+         const std::string &path)
+{
+    const uint8_t *ptr = static_cast<const uint8_t *>(data);
+    while (bytes) {
+        ssize_t ret = pwrite(fd, ptr, bytes, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        fatal_if(ret <= 0, "Write failed on physical memory checkpoint "
+                 "file '%s': %s\n", path, std::strerror(errno));
+        ptr += ret;
+        bytes -= ret;
+        offset += ret;
+    }
+}
+
+void
+readAllBytes(int fd, void *data, uint64_t bytes, uint64_t offset,
+             const std::string &path)
+{
+    uint8_t *ptr = static_cast<uint8_t *>(data);
+    while (bytes) {
+        ssize_t ret = pread(fd, ptr, bytes, offset);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        fatal_if(ret <= 0, "Read failed on physical memory checkpoint "
+                 "file '%s'\n", path);
+        ptr += ret;
+        bytes -= ret;
+        offset += ret;
+    }
+}
+
+/**
+ * Run work on the given number of host threads, the calling thread
+ * included, and wait for all of them to finish.
+ */
+template <typename Work>
+void
+runThreads(unsigned threads, uint64_t max_threads, Work work)
+{
+    threads = std::max<uint64_t>(1, std::min<uint64_t>(threads,
+                                                       max_threads));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(work);
+    work();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+} // anonymous namespace
+
+void
+write(const std::string &path, const uint8_t *pmem, uint64_t size,
+      unsigned threads, bool skip_unpopulated)
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    fatal_if(fd < 0, "Can't open physical memory checkpoint file '%s'\n",
+             path);
+
+    FileHeader header = {};
+    std::copy(magic, magic + sizeof(magic), header.magic);
+    header.version = 1;
+    header.pageBytes = pageBytes;
+    header.chunkPages = chunkPages;
+    header.size = size;
+    header.numChunks = divCeil(size, chunkBytes);
+
+    std::vector<Reader::Chunk> index(header.numChunks);
+    const uint64_t index_offset = sizeof(header);
+    std::atomic<uint64_t> data_end(
+        index_offset + index.size() * sizeof(Reader::Chunk));
+    std::atomic<uint64_t> next_chunk(0);
+
+    runThreads(threads, header.numChunks, [&]() {
+        z_stream zs = {};
+        panic_if(deflateInit(&zs, Z_BEST_SPEED) != Z_OK,
+                 "Failed to initialize zlib.");
+        std::vector<Bytef> out(deflateBound(&zs, chunkBytes));
+
+        for (uint64_t c = next_chunk++; c < header.numChunks;
+             c = next_chunk++) {
+            Reader::Chunk &chunk = index[c];
+            chunk = {};
+
+            // reading untouched memory would map it, so huge sparse
+            // stores are only read where they were touched
+            if (skip_unpopulated &&
+                !host_pages::populated(pmem + c * chunkBytes,
+                                       std::min(chunkBytes,
+                                                size - c * chunkBytes))) {
+                continue;
+            }
+
+            deflateReset(&zs);
+            zs.next_out = out.data();
+            zs.avail_out = out.size();
+
+            bool stored = false;
+            for (unsigned p = 0; p < chunkPages; p++) {
+                const uint64_t start = c * chunkBytes + p * pageBytes;
+                if (start >= size)
+                    break;
+                const uint64_t bytes = std::min(pageBytes, size - start);
+                if (allZero(pmem + start, bytes))
+                    continue;
+
+                chunk.pages[p / 64] |= 1ULL << (p % 64);
+                stored = true;
+                zs.next_in = const_cast<Bytef *>(pmem + start);
+                zs.avail_in = bytes;
+                panic_if(deflate(&zs, Z_NO_FLUSH) != Z_OK || zs.avail_in,
+                         "Failed to compress physical memory.");
+            }
+            if (!stored)
+                continue;
+
+            panic_if(deflate(&zs, Z_FINISH) != Z_STREAM_END,
+                     "Failed to compress physical memory.");
+            chunk.size = out.size() - zs.avail_out;
+            chunk.offset = data_end.fetch_add(chunk.size);
+            writeAll(fd, out.data(), chunk.size, chunk.offset, path);
+        }
+        deflateEnd(&zs);
+    });
+
+    writeAll(fd, &header, sizeof(header), 0, path);
+    writeAll(fd, index.data(), index.size() * sizeof(Reader::Chunk),
+             index_offset, path);
+
+    fatal_if(close(fd), "Close failed on physical memory checkpoint "
+             "file '%s'\n", path);
+}
+
+Reader::Reader(const std::string &_path)
+    : path(_path), fd(open(_path.c_str(), O_RDONLY))
+{
+    fatal_if(fd < 0, "Can't open physical memory checkpoint file '%s'\n",
+             path);
+
+    FileHeader header;
+    readAllBytes(fd, &header, sizeof(header), 0, path);
+    fatal_if(!std::equal(magic, magic + sizeof(magic), header.magic) ||
+             header.version != 1,
+             "'%s' is not a chunked physical memory checkpoint file\n", path);
+    fatal_if(header.pageBytes != pageBytes ||
+             header.chunkPages != chunkPages,
+             "Physical memory checkpoint file '%s' has %d pages of %d "
+             "bytes per chunk, expected %d of %d\n", path,
+             header.chunkPages, header.pageBytes, chunkPages, pageBytes);
+
+    _size = header.size;
+    chunks.resize(header.numChunks);
+    readAllBytes(fd, chunks.data(), chunks.size() * sizeof(Chunk),
+                 sizeof(header), path);
+}
+
+Reader::~Reader()
+{
+    close(fd);
+}
+
+void
+Reader::readChunk(uint64_t c, uint8_t *pmem) const
+{
+    readChunkInto(c, pmem + c * chunkBytes);
+}
+
+void
+Reader::readChunkInto(uint64_t c, uint8_t *buf) const
+{
+    const Chunk &chunk = chunks[c];
+    if (!chunk.size)
+        return;
+
+    std::vector<Bytef> in(chunk.size);
+    readAllBytes(fd, in.data(), in.size(), chunk.offset, path);
+
+    z_stream zs = {};
+    panic_if(inflateInit(&zs) != Z_OK, "Failed to initialize zlib.");
+    zs.next_in = in.data();
+    zs.avail_in = in.size();
+
+    for (unsigned p = 0; p < chunkPages; p++) {
+        if (!(chunk.pages[p / 64] & (1ULL << (p % 64))))
+            continue;
+
+        const uint64_t start = c * chunkBytes + p * pageBytes;
+        zs.next_out = buf + p * pageBytes;
+        zs.avail_out = std::min(pageBytes, _size - start);
+        while (zs.avail_out) {
+            int ret = inflate(&zs, Z_NO_FLUSH);
+            fatal_if(ret != Z_OK && !(ret == Z_STREAM_END && !zs.avail_out),
+                     "Physical memory checkpoint file '%s' is corrupt\n",
+                     path);
+        }
+    }
+    inflateEnd(&zs);
+}
+
+void
+Reader::readAll(uint8_t *pmem, unsigned threads) const
+{
+    std::atomic<uint64_t> next_chunk(0);
+    runThreads(threads, chunks.size(), [&]() {
+        for (uint64_t c = next_chunk++; c < chunks.size(); c = next_chunk++)
+            readChunk(c, pmem);
+    });
+}
+
+} // namespace chunked_store
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,110 @@
+/* @file
+ * Sparse, chunked and compressed image of a backing store
+ */
+
+#ifndef __MEM_CHUNKED_STORE_HH__
+#define __MEM_CHUNKED_STORE_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * A chunked store file holds the contents of a backing store, cut into
+ * chunks that are compressed independently, so they can be written and
+ * read by several host threads, or restored one at a time on demand.
+ * Only the pages of a chunk that are not all zero are stored, and an
+ * index at the start of the file records where each chunk is and which
+ * of its pages it holds.
+ */
+namespace chunked_store
+{
+
+/** Granularity at which all-zero memory is skipped. */
+constexpr uint64_t pageBytes = 4096;
+
+/** Number of pages compressed together. */
+constexpr unsigned chunkPages = 256;
+
+constexpr uint64_t chunkBytes = pageBytes * chunkPages;
+
+/**
+ * Write a backing store to a file.
+ *
+ * @param path Path of the file to create.
+ * @param pmem The host pointer to the backing store.
+ * @param size Size of the backing store in bytes.
+ * @param threads Number of host threads compressing chunks.
+ * @param skip_unpopulated Whether the backing store is a private
+ *                         anonymous mapping, whose chunks that were
+ *                         never touched are known to be zero without
+ *                         reading them.
+ */
+void write(const std::string &path, const uint8_t *pmem, uint64_t size,
+           unsigned threads, bool skip_unpopulated);
+
+class Reader
+{
+  public:
+    /** Location and contents of one chunk in the file. */
+    struct Chunk
+    {
+        uint64_t offset;
+        /** Compressed size, zero if all pages are zero. */
+        uint64_t size;
+        /** Pages of the chunk that are stored. */
+        uint64_t pages[chunkPages / 64];
+    };
+
+  private:
+    const std::string path;
+    int fd;
+    uint64_t _size;
+    std::vector<Chunk> chunks;
+
+  public:
+    /** Open a file and read its index. */
+    Reader(const std::string &path);
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    /** Size of the backing store the file was written from. */
+    uint64_t size() const { return _size; }
+
+    uint64_t numChunks() const { return chunks.size(); }
+
+    /** Whether a chunk only holds zeros. */
+    bool empty(uint64_t chunk) const { return chunks[chunk].size == 0; }
+
+    /**
+     * Restore the stored pages of one chunk. Pages that are all zero
+     * are left untouched. This may be called from several threads.
+     *
+     * @param chunk Index of the chunk.
+     * @param pmem The host pointer to the whole backing store.
+     */
+    void readChunk(uint64_t chunk, uint8_t *pmem) const;
+
+    /**
+     * Restore the stored pages of one chunk into a buffer that only
+     * holds that chunk, leaving its other pages untouched.
+     */
+    void readChunkInto(uint64_t chunk, uint8_t *buf) const;
+
+    /** Restore all chunks, using the given number of host threads. */
+    void readAll(uint8_t *pmem, unsigned threads) const;
+};
+
+} // namespace chunked_store
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_CHUNKED_STORE_HH__
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem/chunked_store.hh"
+#include "mem/host_pages.hh"
+
+using namespace gem5::memory;
+
+namespace
+{
+
+/** A temporary file that is removed when it goes out of scope. */
+class TempFile
+{
+  public:
+    std::string path;
+
+    TempFile()
+    {
+        char name[] = "chunked-store-XXXXXX";
+        int fd = mkstemp(name);
+        EXPECT_NE(-1, fd);
+        close(fd);
+        path = name;
+    }
+
+    ~TempFile() { unlink(path.c_str()); }
+
+    uint64_t
+    size() const
+    {
+        struct stat st;
+        EXPECT_EQ(0, stat(path.c_str(), &st));
+        return st.st_size;
+    }
+};
+
+/**
+ * A store of four and a half chunks, with a partial page at the end, in
+ * which only a few pages of the first and the last chunk are not zero.
+ */
+std::vector<uint8_t>
+sparseStore()
+{
+    const uint64_t size = 4 * chunked_store::chunkBytes +
+        chunked_store::chunkBytes / 2 + 100;
+    std::vector<uint8_t> store(size, 0);
+
+    std::mt19937 rng(1);
+    for (uint64_t i = 0; i < chunked_store::pageBytes; i++)
+        store[i] = rng();
+    for (uint64_t i = 7 * chunked_store::pageBytes;
+         i < 9 * chunked_store::pageBytes; i++)
+        store[i] = i;
+    store[size - 1] = 0x5a;
+    return store;
+}
+
+} // anonymous namespace
+
+/** A store restores to what it was, with one or several threads. */
+TEST(ChunkedStoreTest, RoundTrip)
+{
+    const std::vector<uint8_t> store = sparseStore();
+
+    for (unsigned threads : {1, 3}) {
+        TempFile file;
+        chunked_store::write(file.path, store.data(), store.size(), threads,
+                             false);
+
+        chunked_store::Reader reader(file.path);
+        ASSERT_EQ(store.size(), reader.size());
+        ASSERT_EQ(5, reader.numChunks());
+
+        std::vector<uint8_t> restored(store.size(), 0);
+        reader.readAll(restored.data(), threads);
+        EXPECT_EQ(store, restored);
+    }
+}
+
+/** Chunks that only hold zeros take no space in the file. */
+TEST(ChunkedStoreTest, SkipsZeroChunks)
+{
+    const std::vector<uint8_t> store = sparseStore();
+
+    TempFile file;
+    chunked_store::write(file.path, store.data(), store.size(), 2, false);
+
+    chunked_store::Reader reader(file.path);
+    EXPECT_FALSE(reader.empty(0));
+    EXPECT_TRUE(reader.empty(1));
+    EXPECT_TRUE(reader.empty(2));
+    EXPECT_TRUE(reader.empty(3));
+    EXPECT_FALSE(reader.empty(4));
+
+    // one page of random data, which does not compress, and little else
+    EXPECT_LT(file.size(), 2 * chunked_store::pageBytes);
+}
+
+/** Restoring a single chunk leaves the rest of the store untouched. */
+TEST(ChunkedStoreTest, ReadChunk)
+{
+    const std::vector<uint8_t> store = sparseStore();
+
+    TempFile file;
+    chunked_store::write(file.path, store.data(), store.size(), 1, false);
+
+    chunked_store::Reader reader(file.path);
+    std::vector<uint8_t> restored(store.size(), 0xff);
+    reader.readChunk(4, restored.data());
+
+    EXPECT_EQ(0xff, restored[0]);
+    EXPECT_EQ(0xff, restored[4 * chunked_store::chunkBytes - 1]);
+    EXPECT_EQ(0x5a, restored[store.size() - 1]);
+}
+
+/** Untouched chunks of an anonymous mapping are neither read nor mapped. */
+TEST(ChunkedStoreTest, SkipsUntouchedChunks)
+{
+    const uint64_t size = 8 * chunked_store::chunkBytes;
+    uint8_t *store = static_cast<uint8_t *>(
+        mmap(nullptr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+    ASSERT_NE(MAP_FAILED, store);
+    std::fill(store + 2 * chunked_store::chunkBytes,
+              store + 2 * chunked_store::chunkBytes + 100, 0x5a);
+
+    TempFile file;
+    chunked_store::write(file.path, store, size, 2, true);
+
+    chunked_store::Reader reader(file.path);
+    for (uint64_t c = 0; c < reader.numChunks(); c++)
+        EXPECT_EQ(c != 2, reader.empty(c));
+    EXPECT_FALSE(host_pages::populated(store, chunked_store::chunkBytes));
+
+    std::vector<uint8_t> restored(size, 0);
+    reader.readAll(restored.data(), 1);
+    EXPECT_TRUE(std::equal(restored.begin(), restored.end(), store));
+
+    munmap(store, size);
+}
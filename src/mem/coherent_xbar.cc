@@ -467,6 +467,10 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
+    // remove the request from the routing table, before forwarding
+    // the packet may add new routes and invalidate the lookup
+    routeTo.erase(route_lookup);
+
     // store size and command as they might be modified when
     // forwarding the packet
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
@@ -493,9 +497,6 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     cpuSidePorts[cpu_side_port_id]->schedTimingResp(pkt, curTick()
                                         + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -610,6 +611,10 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
+    // remove the request from the routing table, before forwarding
+    // the packet may add new routes and invalidate the lookup
+    routeTo.erase(route_lookup);
+
     // store size and command as they might be modified when
     // forwarding the packet
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
@@ -684,9 +689,6 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
         respLayers[dest_port_id]->succeededTiming(packetFinishTime);
     }
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     // stats updates
     transDist[pkt_cmd]++;
     snoops++;
@@ -46,9 +46,15 @@
 
 #include "mem/cxl_bridge.hh"
 
+#include <cmath>
+
+#include "base/binary_trace.hh"
+#include "base/intmath.hh"
+#include "base/random.hh"
 #include "base/trace.hh"
 #include "debug/Bridge.hh"
 #include "params/Bridge.hh"
+#include "sim/system.hh"
 #include "debug/CXLMemory.hh"
 #include <iterator>
 
@@ -65,7 +71,15 @@ CXLBridge::BridgeResponsePort::BridgeResponsePort(const std::string& _name,
       proto_proc_lat(_proto_proc_lat),
       ranges(_ranges.begin(), _ranges.end()),
       outstandingResponses(0), retryReq(false), respQueueLimit(_resp_limit),
-      sendEvent([this]{ trySendTiming(); }, _name)
+      sendEvent([this]{ trySendTiming(); }, _name),
+      retryEvent([this]{
+          {
+              std::lock_guard<std::mutex> lock(bridge.linkLock);
+              retryPending = false;
+          }
+          retryStalledReq();
+      }, _name + ".retry"),
+      retryPending(false)
 {
     for (auto i=ranges.begin(); i!=ranges.end(); i++)
         DPRINTF(CXLMemory, "BridgeResponsePort.ranges = %s\n", i->to_string());
@@ -90,9 +104,22 @@ CXLBridge::CXLBridge(const Params &p)
       cpuSidePort(p.name + ".cpu_side_port", *this, memSidePort,
                 ticksToCycles(p.bridge_lat), ticksToCycles(p.proto_proc_lat), p.resp_fifo_depth, p.ranges),
       memSidePort(p.name + ".mem_side_port", *this, cpuSidePort,
-                ticksToCycles(p.bridge_lat), ticksToCycles(p.proto_proc_lat), p.req_fifo_depth),      
+                ticksToCycles(p.bridge_lat), ticksToCycles(p.proto_proc_lat), p.req_fifo_depth),
+      linkBer(p.link_ber), flitSize(p.flit_size), flitLat(p.flit_lat),
+      llrReplayLat(p.llr_replay_lat), llrBufSize(p.llr_buf_size),
+      flitErrorProb(1.0 - std::pow(1.0 - p.link_ber, p.flit_size * 8.0)),
+      memSideQueue(getEventQueue(p.mem_side_eventq_index)),
+      traceId(binary_trace::objectId(p.name)),
+      crossQueue(p.mem_side_eventq_index != p.eventq_index),
+      bridgeLat(p.bridge_lat),
+      system(p.system),
       stats(*this)
 {
+    fatal_if(linkBer < 0 || linkBer >= 1,
+             "%s: link_ber must be in [0, 1)\n", name());
+    fatal_if(flitSize == 0, "%s: flit_size must be non-zero\n", name());
+    fatal_if(linkBer > 0 && flitLat == 0,
+             "%s: flit_lat must be non-zero when link_ber is set\n", name());
 }
 
 CXLBridge::CXLBridgeStats::CXLBridgeStats(CXLBridge &_bridge)
@@ -116,7 +143,18 @@ CXLBridge::CXLBridgeStats::CXLBridgeStats(CXLBridge &_bridge)
       ADD_STAT(rspQueueLenDist, "Response queue length distribution (Count)"),
       ADD_STAT(rspOutStandDist, "outstandingResponses distribution (Count)"),
       ADD_STAT(reqQueueLatDist, "Response queue latency distribution (Tick)"),
-      ADD_STAT(rspQueueLatDist, "Response queue latency distribution (Tick)")
+      ADD_STAT(rspQueueLatDist, "Response queue latency distribution (Tick)"),
+      ADD_STAT(linkFlits, statistics::units::Count::get(),
+               "Number of flits sent over the CXL link"),
+      ADD_STAT(crcErrors, statistics::units::Count::get(),
+               "Number of flits that failed the CRC check (link retries)"),
+      ADD_STAT(llrReplayedFlits, statistics::units::Count::get(),
+               "Number of flits replayed from the link layer retry buffer"),
+      ADD_STAT(llrReplayTicks, statistics::units::Tick::get(),
+               "Total delay added by link layer retries"),
+      ADD_STAT(linkBwLoss, statistics::units::Ratio::get(),
+               "Fraction of the link bandwidth spent on replays",
+               llrReplayedFlits / (linkFlits + llrReplayedFlits))
 {
     reqQueueLenDist
         .init(0, 129, 10)
@@ -158,6 +196,80 @@ CXLBridge::init()
     cpuSidePort.sendRangeChange();
 }
 
+void
+CXLBridge::startup()
+{
+    checkQuantum();
+}
+
+void
+CXLBridge::drainResume()
+{
+    // the memory mode and the quantum may change while drained, e.g.
+    // when switching from KVM to timing cores
+    checkQuantum();
+}
+
+void
+CXLBridge::checkQuantum() const
+{
+    // everything a request can reach on the other side must be at least
+    // one quantum ahead of it
+    fatal_if(crossQueue && system->isTimingMode() &&
+             (simQuantum == 0 ||
+              simQuantum > bridgeLat),
+             "%s: sim_quantum must be non-zero and at most bridge_lat when "
+             "the two sides of the bridge use separate event queues\n",
+             name());
+}
+
+Tick
+CXLBridge::memSideClockEdge(Cycles cycles) const
+{
+    if (!crossQueue)
+        return clockEdge(cycles);
+
+    return divCeil(curTick(), clockPeriod()) * clockPeriod() +
+        cycles * clockPeriod();
+}
+
+Tick
+CXLBridge::linkRetryDelay(PacketPtr pkt)
+{
+    // one header flit plus the flits carrying the payload
+    unsigned flits = 1 + (pkt->hasData() ? divCeil(pkt->getSize(),
+                                                   flitSize) : 0);
+    stats.linkFlits += flits;
+
+    if (linkBer == 0)
+        return 0;
+
+    // on a CRC error the receiver requests a replay, and the sender
+    // resends the failing flit and everything sent after it that is
+    // still held in the retry buffer, i.e. the flits that were in
+    // flight during the replay round trip
+    const unsigned window = std::min<uint64_t>(llrBufSize,
+        divCeil(llrReplayLat, flitLat) + 1);
+
+    Tick delay = 0;
+    for (unsigned i = 0; i < flits; i++) {
+        if (random.random<double>() >= flitErrorProb)
+            continue;
+
+        stats.crcErrors++;
+        stats.llrReplayedFlits += window;
+        delay += llrReplayLat + window * flitLat;
+    }
+
+    if (delay) {
+        DPRINTF(CXLMemory, "Link retry on %s addr 0x%x delays %ld ticks\n",
+                pkt->cmdString(), pkt->getAddr(), delay);
+        stats.llrReplayTicks += delay;
+    }
+
+    return delay;
+}
+
 bool
 CXLBridge::BridgeResponsePort::respQueueFull() const
 {
@@ -185,10 +297,10 @@ CXLBridge::BridgeRequestPort::recvTimingResp(PacketPtr pkt)
 {
     // all checks are done when the request is accepted on the response
     // side, so we are guaranteed to have space for the response
-    DPRINTF(Bridge, "recvTimingResp: %s addr 0x%x\n",
-            pkt->cmdString(), pkt->getAddr());
+    std::lock_guard<std::mutex> lock(bridge.linkLock);
 
-    DPRINTF(Bridge, "Request queue size: %d\n", transmitList.size());
+    BTRACE(Bridge, bridge.traceId, "recvTimingResp", pkt->getAddr(),
+           pkt->cmdToIndex(), transmitList.size());
 
     // technically the packet only reaches us after the header delay,
     // and typically we also need to deserialise any payload (unless
@@ -206,10 +318,12 @@ CXLBridge::BridgeRequestPort::recvTimingResp(PacketPtr pkt)
         }
         else
             DPRINTF(CXLMemory, "the cmd of packet is %s, not a read or write.\n", pkt->cmd.toString());
-        DPRINTF(CXLMemory, "recvTimingResp: %s addr 0x%x, when tick%ld\n", 
-            pkt->cmdString(), pkt->getAddr(), bridge.clockEdge(total_delay) + receive_delay);
+        receive_delay += bridge.linkRetryDelay(pkt);
+        BTRACE(CXLMemory, bridge.traceId, "cxlTimingResp", pkt->getAddr(),
+               pkt->cmdToIndex(),
+               bridge.memSideClockEdge(total_delay) + receive_delay);
     }
-    cpuSidePort.schedTimingResp(pkt, bridge.clockEdge(total_delay) +
+    cpuSidePort.schedTimingResp(pkt, bridge.memSideClockEdge(total_delay) +
                               receive_delay);
 
     return true;
@@ -218,9 +332,6 @@ CXLBridge::BridgeRequestPort::recvTimingResp(PacketPtr pkt)
 bool
 CXLBridge::BridgeResponsePort::recvTimingReq(PacketPtr pkt)
 {
-    DPRINTF(Bridge, "recvTimingReq: %s addr 0x%x\n",
-            pkt->cmdString(), pkt->getAddr());
-
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
 
@@ -230,8 +341,10 @@ CXLBridge::BridgeResponsePort::recvTimingReq(PacketPtr pkt)
     if (retryReq)
         return false;
 
-    DPRINTF(Bridge, "Response queue size: %d outresp: %d\n",
-            transmitList.size(), outstandingResponses);
+    std::lock_guard<std::mutex> lock(bridge.linkLock);
+
+    BTRACE(Bridge, bridge.traceId, "recvTimingReq", pkt->getAddr(),
+           pkt->cmdToIndex(), transmitList.size());
 
     // if the request queue is full then there is no hope
     if (memSidePort.reqQueueFull()) {
@@ -272,8 +385,10 @@ CXLBridge::BridgeResponsePort::recvTimingReq(PacketPtr pkt)
                     pkt->cxl_cmd = MemCmd::M2SRwD;
                 else
                     DPRINTF(CXLMemory, "the cmd of packet is %s, not a read or write.\n", pkt->cmd.toString());
-                DPRINTF(CXLMemory, "recvTimingReq: %s addr 0x%x, when tick%ld\n", 
-                    pkt->cmdString(), pkt->getAddr(), bridge.clockEdge(total_delay) + receive_delay);
+                receive_delay += bridge.linkRetryDelay(pkt);
+                BTRACE(CXLMemory, bridge.traceId, "cxlTimingReq",
+                       pkt->getAddr(), pkt->cmdToIndex(),
+                       bridge.clockEdge(total_delay) + receive_delay);
             }
             memSidePort.schedTimingReq(pkt, bridge.clockEdge(total_delay) +
                                       receive_delay);
@@ -298,6 +413,24 @@ CXLBridge::BridgeResponsePort::retryStalledReq()
     }
 }
 
+void
+CXLBridge::BridgeResponsePort::schedRetryStalledReq()
+{
+    if (!bridge.crossQueue) {
+        retryStalledReq();
+        return;
+    }
+
+    // retryReq belongs to the cpu side thread, which may be up to a
+    // quantum behind or ahead of us, so the retry is handed over like
+    // a packet
+    std::lock_guard<std::mutex> lock(bridge.linkLock);
+    if (!retryPending) {
+        retryPending = true;
+        bridge.schedule(retryEvent, bridge.memSideClockEdge(bridge_lat));
+    }
+}
+
 void
 CXLBridge::BridgeRequestPort::schedTimingReq(PacketPtr pkt, Tick when)
 {
@@ -306,7 +439,7 @@ CXLBridge::BridgeRequestPort::schedTimingReq(PacketPtr pkt, Tick when)
     // should already be an event scheduled for sending the head
     // packet.
     if (transmitList.empty()) {
-        bridge.schedule(sendEvent, when);
+        bridge.memSideQueue->schedule(&sendEvent, when);
     }
 
     assert(transmitList.size() != reqQueueLimit);
@@ -336,40 +469,51 @@ CXLBridge::BridgeResponsePort::schedTimingResp(PacketPtr pkt, Tick when)
 void
 CXLBridge::BridgeRequestPort::trySendTiming()
 {
-    assert(!transmitList.empty());
+    PacketPtr pkt;
+    {
+        std::lock_guard<std::mutex> lock(bridge.linkLock);
 
-    DeferredPacket req = transmitList.front();
+        assert(!transmitList.empty());
 
-    assert(req.tick <= curTick());
+        DeferredPacket req = transmitList.front();
 
-    PacketPtr pkt = req.pkt;
+        assert(req.tick <= curTick());
 
-    DPRINTF(Bridge, "trySend request addr 0x%x, queue size %d\n",
-            pkt->getAddr(), transmitList.size());
+        pkt = req.pkt;
+
+        BTRACE(Bridge, bridge.traceId, "sendTimingReq", pkt->getAddr(),
+               pkt->cmdToIndex(), transmitList.size());
+    }
 
     if (sendTimingReq(pkt)) {
-        // send successful
-        bridge.stats.reqSendSucceed++;
+        {
+            std::lock_guard<std::mutex> lock(bridge.linkLock);
+
+            // send successful
+            bridge.stats.reqSendSucceed++;
 
-        transmitList.pop_front();
+            transmitList.pop_front();
 
-        bridge.stats.reqQueueLenDist.sample(transmitList.size());
-        DPRINTF(Bridge, "trySend request successful\n");
+            bridge.stats.reqQueueLenDist.sample(transmitList.size());
+            DPRINTF(Bridge, "trySend request successful\n");
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_req = transmitList.front();
-            DPRINTF(Bridge, "Scheduling next send\n");
-            bridge.schedule(sendEvent, std::max(next_req.tick,
-                                                bridge.clockEdge()));
+            // If there are more packets to send, schedule event to try
+            // again.
+            if (!transmitList.empty()) {
+                DeferredPacket next_req = transmitList.front();
+                DPRINTF(Bridge, "Scheduling next send\n");
+                bridge.memSideQueue->schedule(&sendEvent,
+                    std::max(next_req.tick, bridge.memSideClockEdge()));
+            }
         }
 
         // if we have stalled a request due to a full request queue,
         // then send a retry at this point, also note that if the
         // request we stalled was waiting for the response queue
         // rather than the request queue we might stall it again
-        cpuSidePort.retryStalledReq();
+        cpuSidePort.schedRetryStalledReq();
     } else {
+        std::lock_guard<std::mutex> lock(bridge.linkLock);
         bridge.stats.reqSendFaild++;
     }
 
@@ -380,49 +524,63 @@ CXLBridge::BridgeRequestPort::trySendTiming()
 void
 CXLBridge::BridgeResponsePort::trySendTiming()
 {
-    assert(!transmitList.empty());
+    PacketPtr pkt;
+    {
+        std::lock_guard<std::mutex> lock(bridge.linkLock);
 
-    DeferredPacket resp = transmitList.front();
+        assert(!transmitList.empty());
 
-    assert(resp.tick <= curTick());
+        DeferredPacket resp = transmitList.front();
 
-    PacketPtr pkt = resp.pkt;
+        assert(resp.tick <= curTick());
 
-    DPRINTF(Bridge, "trySend response addr 0x%x, outstanding %d\n",
-            pkt->getAddr(), outstandingResponses);
+        pkt = resp.pkt;
+
+        BTRACE(Bridge, bridge.traceId, "sendTimingResp", pkt->getAddr(),
+               pkt->cmdToIndex(), outstandingResponses);
+    }
 
     if (sendTimingResp(pkt)) {
-        // send successful
-        bridge.stats.rspSendSucceed++;
+        bool req_queue_full;
+        {
+            std::lock_guard<std::mutex> lock(bridge.linkLock);
+
+            // send successful
+            bridge.stats.rspSendSucceed++;
 
-        transmitList.pop_front();
+            transmitList.pop_front();
 
-        bridge.stats.rspQueueLenDist.sample(transmitList.size());
-        DPRINTF(Bridge, "trySend response successful\n");
+            bridge.stats.rspQueueLenDist.sample(transmitList.size());
+            DPRINTF(Bridge, "trySend response successful\n");
 
-        assert(outstandingResponses != 0);
-        --outstandingResponses;
+            assert(outstandingResponses != 0);
+            --outstandingResponses;
 
-        bridge.stats.rspOutStandDist.sample(outstandingResponses);
+            bridge.stats.rspOutStandDist.sample(outstandingResponses);
+
+            // If there are more packets to send, schedule event to try
+            // again.
+            if (!transmitList.empty()) {
+                DeferredPacket next_resp = transmitList.front();
+                DPRINTF(Bridge, "Scheduling next send\n");
+                bridge.schedule(sendEvent, std::max(next_resp.tick,
+                                                    bridge.clockEdge()));
+            }
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_resp = transmitList.front();
-            DPRINTF(Bridge, "Scheduling next send\n");
-            bridge.schedule(sendEvent, std::max(next_resp.tick,
-                                                bridge.clockEdge()));
+            req_queue_full = memSidePort.reqQueueFull();
         }
 
         // if there is space in the request queue and we were stalling
         // a request, it will definitely be possible to accept it now
         // since there is guaranteed space in the response queue
-        if (!memSidePort.reqQueueFull() && retryReq) {
+        if (!req_queue_full && retryReq) {
             DPRINTF(Bridge, "Request waiting for retry, now retrying\n");
             retryReq = false;
             sendRetryReq();
             bridge.stats.reqRetryCounts++;
         }
     } else {
+        std::lock_guard<std::mutex> lock(bridge.linkLock);
         bridge.stats.rspSendFaild++;
     }
 
@@ -447,6 +605,11 @@ CXLBridge::BridgeResponsePort::recvAtomic(PacketPtr pkt)
 {
     panic_if(pkt->cacheResponding(), "Should not see packets where cache "
              "is responding");
+
+    // as for the ThreadBridge, atomic accesses simply run on the mem
+    // side event queue, which does nothing if there is only one queue
+    EventQueue::ScopedMigration migrate(bridge.memSideQueue);
+
     if (pkt->getAddr() >= cxl_range.start() && pkt->getAddr() < cxl_range.end()) {
         DPRINTF(CXLMemory, "the cmd of pkt is %s, addrRange is %s.\n",
             pkt->cmd.toString(), pkt->getAddrRange().to_string());
@@ -456,8 +619,11 @@ CXLBridge::BridgeResponsePort::recvAtomic(PacketPtr pkt)
             pkt->cxl_cmd = MemCmd::M2SRwD;
         else
             DPRINTF(CXLMemory, "the cmd of packet is %s, not a read or write.\n", pkt->cmd.toString());
+        Tick link_delay = bridge.linkRetryDelay(pkt);
         Tick access_delay = memSidePort.sendAtomic(pkt);
-        Tick total_delay = (bridge_lat + proto_proc_lat) * bridge.clockPeriod() + access_delay;
+        link_delay += bridge.linkRetryDelay(pkt);
+        Tick total_delay = (bridge_lat + proto_proc_lat) * bridge.clockPeriod() +
+            access_delay + link_delay;
         return total_delay;
     }
     else {
@@ -469,6 +635,28 @@ Tick
 CXLBridge::BridgeResponsePort::recvAtomicBackdoor(
     PacketPtr pkt, MemBackdoorPtr &backdoor)
 {
+    EventQueue::ScopedMigration migrate(bridge.memSideQueue);
+
+    if (pkt->getAddr() >= cxl_range.start() && pkt->getAddr() < cxl_range.end()) {
+        // same accounting as recvAtomic, but let the CXL device hand out
+        // a backdoor so that fast-forwarding CPUs can bypass the link
+        if (pkt->isRead())
+            pkt->cxl_cmd = MemCmd::M2SReq;
+        else if (pkt->isWrite())
+            pkt->cxl_cmd = MemCmd::M2SRwD;
+        Tick link_delay = bridge.linkRetryDelay(pkt);
+        Tick access_delay = memSidePort.sendAtomicBackdoor(pkt, backdoor);
+        link_delay += bridge.linkRetryDelay(pkt);
+        Tick total = (bridge_lat + proto_proc_lat) * bridge.clockPeriod() +
+            access_delay + link_delay;
+
+        // the accesses through the backdoor skip the link, so they are
+        // charged the latency of the access that got it instead
+        if (backdoor)
+            backdoor->latency(total);
+        return total;
+    }
+
     return bridge_lat * bridge.clockPeriod() + memSidePort.sendAtomicBackdoor(
         pkt, backdoor);
 }
@@ -478,22 +666,27 @@ CXLBridge::BridgeResponsePort::recvFunctional(PacketPtr pkt)
 {
     pkt->pushLabel(name());
 
-    // check the response queue
-    for (auto i = transmitList.begin();  i != transmitList.end(); ++i) {
-        if (pkt->trySatisfyFunctional((*i).pkt)) {
-            pkt->makeResponse();
-            return;
+    {
+        std::lock_guard<std::mutex> lock(bridge.linkLock);
+
+        // check the response queue
+        for (auto i = transmitList.begin();  i != transmitList.end(); ++i) {
+            if (pkt->trySatisfyFunctional((*i).pkt)) {
+                pkt->makeResponse();
+                return;
+            }
         }
-    }
 
-    // also check the request port's request queue
-    if (memSidePort.trySatisfyFunctional(pkt)) {
-        return;
+        // also check the request port's request queue
+        if (memSidePort.trySatisfyFunctional(pkt)) {
+            return;
+        }
     }
 
     pkt->popLabel();
 
     // fall through if pkt still not satisfied
+    EventQueue::ScopedMigration migrate(bridge.memSideQueue);
     memSidePort.sendFunctional(pkt);
 }
 
@@ -501,7 +694,14 @@ void
 CXLBridge::BridgeResponsePort::recvMemBackdoorReq(
     const MemBackdoorReq &req, MemBackdoorPtr &backdoor)
 {
+    EventQueue::ScopedMigration migrate(bridge.memSideQueue);
     memSidePort.sendMemBackdoorReq(req, backdoor);
+
+    // on top of the latency of the device, without retries nor the media
+    if (backdoor && req.range().intersects(cxl_range)) {
+        Tick link = (bridge_lat + proto_proc_lat) * bridge.clockPeriod();
+        backdoor->latency(backdoor->latency() + link);
+    }
 }
 
 bool
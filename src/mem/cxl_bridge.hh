@@ -48,7 +48,9 @@
 #define __MEM_CXL_BRIDGE_HH__
 
 #include <deque>
+#include <mutex>
 
+#include "base/random.hh"
 #include "base/types.hh"
 #include "base/statistics.hh"
 #include "mem/port.hh"
@@ -58,6 +60,8 @@
 namespace gem5
 {
 
+class System;
+
 class CXLBridge : public ClockedObject
 {
   protected:
@@ -149,6 +153,15 @@ class CXLBridge : public ClockedObject
         /** Send event for the response queue. */
         EventFunctionWrapper sendEvent;
 
+        /**
+         * Retry event for requests stalled on a full request queue, used
+         * when the request queue drains on the mem side thread.
+         */
+        EventFunctionWrapper retryEvent;
+
+        /** Is retryEvent in flight, protected by the link lock. */
+        bool retryPending;
+
       public:
 
         /**
@@ -183,6 +196,14 @@ class CXLBridge : public ClockedObject
          */
         void retryStalledReq();
 
+        /**
+         * Called from the mem side once there is space in the request
+         * queue. Retries right away if both sides share an event queue,
+         * and otherwise hands the retry over to the cpu side thread one
+         * bridge latency later. The link lock must not be held.
+         */
+        void schedRetryStalledReq();
+
         AddrRange cxl_range;
 
       protected:
@@ -326,6 +347,78 @@ class CXLBridge : public ClockedObject
     /** Request port of the bridge. */
     BridgeRequestPort memSidePort;
 
+    /** Bit error rate of the CXL link, zero disables error injection. */
+    const double linkBer;
+
+    /** Size of a link flit in bytes. */
+    const unsigned flitSize;
+
+    /** Time to transmit one flit on the link. */
+    const Tick flitLat;
+
+    /** Latency from a CRC error to the start of the replay. */
+    const Tick llrReplayLat;
+
+    /** Number of flits held by the link layer retry buffer. */
+    const unsigned llrBufSize;
+
+    /** Probability that a flit fails its CRC check. */
+    const double flitErrorProb;
+
+    /** Event queue of the mem side port and everything behind it. */
+    EventQueue *memSideQueue;
+
+    /** Id of the bridge in binary traces. */
+    const uint32_t traceId;
+
+    /** Are the two sides of the bridge simulated by separate threads. */
+    const bool crossQueue;
+
+    /** Latency of the bridge, the lookahead between its two sides. */
+    const Tick bridgeLat;
+
+    /** The system, whose memory mode decides if the quantum matters. */
+    System *system;
+
+    /**
+     * Random numbers of the link model. The bridge has its own, as it
+     * may be used by two simulation threads, and only uses them under
+     * linkLock in timing mode.
+     */
+    Random random;
+
+    /**
+     * Protects the state shared by the two sides of the bridge, i.e. the
+     * packet queues and the link model. It is never held while sending
+     * a packet out of the bridge.
+     */
+    std::mutex linkLock;
+
+    /**
+     * Clock edge as seen by the mem side. The cached clock edge of the
+     * ClockedObject belongs to the cpu side thread, so the mem side
+     * computes its own when the sides run on separate threads.
+     */
+    Tick memSideClockEdge(Cycles cycles=Cycles(0)) const;
+
+    /**
+     * Inject CRC errors on the flits of a packet crossing the CXL link
+     * and compute the cost of the resulting link layer retries (LLR).
+     *
+     * @param pkt the packet crossing the link
+     * @return the extra delay due to replays from the retry buffer
+     */
+    Tick linkRetryDelay(PacketPtr pkt);
+
+    /**
+     * Check that the quantum is at most the bridge latency, which is
+     * the lookahead between the two sides, if they use separate event
+     * queues and the system is in timing mode. Atomic accesses cross
+     * the queues synchronously, so KVM and atomic cores may run with a
+     * longer quantum.
+     */
+    void checkQuantum() const;
+
     struct CXLBridgeStats : public statistics::Group
     {
         CXLBridgeStats(CXLBridge &bridge);
@@ -342,6 +435,11 @@ class CXLBridge : public ClockedObject
         statistics::Distribution rspOutStandDist;
         statistics::Distribution reqQueueLatDist;
         statistics::Distribution rspQueueLatDist;
+        statistics::Scalar linkFlits;
+        statistics::Scalar crcErrors;
+        statistics::Scalar llrReplayedFlits;
+        statistics::Scalar llrReplayTicks;
+        statistics::Formula linkBwLoss;
     };
 
     CXLBridgeStats stats;
@@ -352,6 +450,8 @@ class CXLBridge : public ClockedObject
                   PortID idx=InvalidPortID) override;
 
     void init() override;
+    void startup() override;
+    void drainResume() override;
 
     typedef CXLBridgeParams Params;
 
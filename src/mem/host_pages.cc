@@ -0,0 +1,115 @@
+#include "mem/host_pages.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+namespace host_pages
+{
+
+namespace
+{
+
+const uint64_t hostPageSize = sysconf(_SC_PAGE_SIZE);
+
+/** Bit of a /proc/self/pagemap entry set for pages swapped out. */
+const uint64_t pagemapSwapped = 1ULL << 62;
+
+} // anonymous namespace
+
+Usage
+usage(const void *addr, uint64_t size)
+{
+    return usage({{addr, size}}).front();
+}
+
+std::vector<Usage>
+usage(const std::vector<std::pair<const void *, uint64_t>> &ranges)
+{
+    std::vector<Usage> totals(ranges.size());
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    // share of the current mapping that lies in each range
+    std::vector<double> overlaps(ranges.size());
+    bool overlapping = false;
+    while (std::getline(smaps, line)) {
+        uint64_t map_start, map_end, kb;
+        if (std::sscanf(line.c_str(), "%" SCNx64 "-%" SCNx64,
+                        &map_start, &map_end) == 2) {
+            overlapping = false;
+            for (size_t i = 0; i < ranges.size(); i++) {
+                const uint64_t start =
+                    reinterpret_cast<uintptr_t>(ranges[i].first);
+                const uint64_t lo = std::max(start, map_start);
+                const uint64_t hi = std::min(start + ranges[i].second,
+                                             map_end);
+                overlaps[i] =
+                    lo < hi ? double(hi - lo) / (map_end - map_start) : 0;
+                overlapping = overlapping || overlaps[i] != 0;
+            }
+        } else if (!overlapping) {
+            continue;
+        } else if (std::sscanf(line.c_str(), "Rss: %" SCNu64 " kB",
+                               &kb) == 1) {
+            for (size_t i = 0; i < ranges.size(); i++)
+                totals[i].resident += kb * 1024 * overlaps[i];
+        } else if (std::sscanf(line.c_str(), "Pss: %" SCNu64 " kB",
+                               &kb) == 1) {
+            for (size_t i = 0; i < ranges.size(); i++)
+                totals[i].proportional += kb * 1024 * overlaps[i];
+        }
+    }
+    return totals;
+}
+
+bool
+populated(const void *addr, uint64_t size)
+{
+    const uint64_t start = roundDown(reinterpret_cast<uintptr_t>(addr),
+                                     hostPageSize);
+    const uint64_t pages = divCeil(
+        reinterpret_cast<uintptr_t>(addr) + size - start, hostPageSize);
+
+    std::vector<unsigned char> resident(pages);
+    if (mincore(reinterpret_cast<void *>(start), pages * hostPageSize,
+                resident.data()) != 0) {
+        return true;
+    }
+    if (std::any_of(resident.begin(), resident.end(),
+                    [](unsigned char r) { return r & 1; })) {
+        return true;
+    }
+
+    // the pages that are not resident may have been swapped out
+    static const int pagemap = open("/proc/self/pagemap", O_RDONLY);
+    if (pagemap < 0)
+        return true;
+
+    std::vector<uint64_t> entries(pages);
+    const ssize_t bytes = entries.size() * sizeof(uint64_t);
+    if (pread(pagemap, entries.data(), bytes,
+              start / hostPageSize * sizeof(uint64_t)) != bytes) {
+        return true;
+    }
+    return std::any_of(entries.begin(), entries.end(),
+                       [](uint64_t e) { return e & pagemapSwapped; });
+}
+
+} // namespace host_pages
+} // namespace memory
+} // namespace gem5
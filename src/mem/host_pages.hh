@@ -0,0 +1,68 @@
+/* @file
+ * Queries of the host memory behind a backing store
+ */
+
+#ifndef __MEM_HOST_PAGES_HH__
+#define __MEM_HOST_PAGES_HH__
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gem5
+{
+
+namespace memory
+{
+
+namespace host_pages
+{
+
+/** Host memory taken by a range of host addresses. */
+struct Usage
+{
+    /** Bytes resident in host memory. */
+    uint64_t resident;
+    /** Resident bytes, with pages shared by n mappings counting 1/n. */
+    uint64_t proportional;
+};
+
+/**
+ * Get the host memory taken by a range of host addresses, as the kernel
+ * reports it in /proc/self/smaps. Reads of untouched pages map the shared
+ * zero page, which is not counted, and pages merged with identical pages
+ * only count in proportion to their sharers in the proportional size.
+ * Mappings that only partly overlap the range count in proportion to the
+ * overlap.
+ *
+ * @param addr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+Usage usage(const void *addr, uint64_t size);
+
+/**
+ * Get the host memory taken by several ranges of host addresses, reading
+ * /proc/self/smaps only once.
+ *
+ * @param ranges Start and size in bytes of each range.
+ * @return The usage of each range.
+ */
+std::vector<Usage>
+usage(const std::vector<std::pair<const void *, uint64_t>> &ranges);
+
+/**
+ * Check whether any page of a range of a private anonymous mapping may
+ * hold data, i.e. is resident in host memory or swapped out. All pages
+ * of a range that is not populated read as zero. If the host cannot
+ * tell, the range is reported as populated.
+ *
+ * @param addr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+bool populated(const void *addr, uint64_t size);
+
+} // namespace host_pages
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_HOST_PAGES_HH__
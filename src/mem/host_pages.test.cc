@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "mem/host_pages.hh"
+
+using namespace gem5::memory;
+
+namespace
+{
+
+const uint64_t pageSize = sysconf(_SC_PAGE_SIZE);
+
+/** An anonymous mapping of small pages, unmapped when going away. */
+class Mapping
+{
+  public:
+    const uint64_t size;
+    volatile uint8_t *data;
+
+    Mapping(uint64_t pages) : size(pages * pageSize)
+    {
+        void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                          -1, 0);
+        EXPECT_NE(MAP_FAILED, addr);
+        madvise(addr, size, MADV_NOHUGEPAGE);
+        data = static_cast<uint8_t *>(addr);
+    }
+
+    ~Mapping() { munmap(const_cast<uint8_t *>(data), size); }
+
+    const void *page(uint64_t p) const
+    {
+        return const_cast<uint8_t *>(data) + p * pageSize;
+    }
+};
+
+} // anonymous namespace
+
+/** Pages are populated once they are read or written. */
+TEST(HostPagesTest, Populated)
+{
+    Mapping mapping(16);
+    EXPECT_FALSE(host_pages::populated(mapping.page(0), mapping.size));
+
+    (void)mapping.data[3 * pageSize];
+    mapping.data[9 * pageSize + 10] = 1;
+    EXPECT_TRUE(host_pages::populated(mapping.page(3), pageSize));
+    EXPECT_TRUE(host_pages::populated(mapping.page(9), 2 * pageSize));
+    EXPECT_FALSE(host_pages::populated(mapping.page(4), 5 * pageSize));
+    EXPECT_FALSE(host_pages::populated(mapping.page(10), 6 * pageSize));
+}
+
+/** Only written pages take host memory, reads map the zero page. */
+TEST(HostPagesTest, Usage)
+{
+    Mapping mapping(16);
+    for (uint64_t p = 0; p < 16; p++)
+        (void)mapping.data[p * pageSize];
+    EXPECT_EQ(0, host_pages::usage(mapping.page(0), mapping.size).resident);
+
+    mapping.data[2 * pageSize] = 1;
+    mapping.data[5 * pageSize] = 1;
+    const host_pages::Usage usage =
+        host_pages::usage(mapping.page(0), mapping.size);
+    EXPECT_EQ(2 * pageSize, usage.resident);
+    EXPECT_EQ(2 * pageSize, usage.proportional);
+}
+
+/** Several ranges are measured at once, each on its own. */
+TEST(HostPagesTest, UsageOfRanges)
+{
+    Mapping first(8), second(8);
+    first.data[pageSize] = 1;
+    second.data[0] = 1;
+    second.data[3 * pageSize] = 1;
+    second.data[7 * pageSize] = 1;
+
+    const std::vector<host_pages::Usage> usages = host_pages::usage(
+        {{first.page(0), first.size}, {second.page(0), second.size},
+         {second.page(2), 4 * pageSize}});
+    ASSERT_EQ(3, usages.size());
+    EXPECT_EQ(pageSize, usages[0].resident);
+    EXPECT_EQ(3 * pageSize, usages[1].resident);
+    // half of the second mapping, so half of its resident pages
+    EXPECT_EQ(3 * pageSize / 2, usages[2].resident);
+}
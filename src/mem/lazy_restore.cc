@@ -0,0 +1,243 @@
+#include "mem/lazy_restore.hh"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <set>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+#if defined(__linux__) && defined(__NR_userfaultfd)
+#define HAVE_USERFAULTFD 1
+#endif
+
+namespace gem5
+{
+
+namespace memory
+{
+
+#if HAVE_USERFAULTFD
+
+namespace
+{
+
+std::mutex activeLock;
+
+/** Restores in progress, which have to finish before a fork. */
+std::set<LazyRestore *> active;
+
+void
+restoreAllBeforeFork()
+{
+    std::lock_guard<std::mutex> guard(activeLock);
+    for (LazyRestore *restore : active)
+        restore->restoreAll();
+}
+
+/**
+ * Fill a range of a registered backing store, with zeros if src is null.
+ *
+ * @return False if some pages of the range are already there.
+ */
+bool
+fillRange(int uffd, uint64_t dst, const uint8_t *src, uint64_t bytes)
+{
+    int ret;
+    if (src) {
+        uffdio_copy copy = {};
+        copy.dst = dst;
+        copy.src = reinterpret_cast<uint64_t>(src);
+        copy.len = bytes;
+        ret = ioctl(uffd, UFFDIO_COPY, &copy);
+    } else {
+        uffdio_zeropage zero = {};
+        zero.range.start = dst;
+        zero.range.len = bytes;
+        ret = ioctl(uffd, UFFDIO_ZEROPAGE, &zero);
+    }
+    panic_if(ret && errno != EEXIST, "Could not restore a backing store: %s",
+             std::strerror(errno));
+    return !ret;
+}
+
+} // anonymous namespace
+
+std::unique_ptr<LazyRestore>
+LazyRestore::create(const std::string &path, uint8_t *pmem, uint64_t size)
+{
+    const uint64_t host_page_size = sysconf(_SC_PAGE_SIZE);
+    if (chunked_store::chunkBytes % host_page_size) {
+        warn("Restoring '%s' eagerly, host pages are larger than a "
+             "chunk.\n", path);
+        return nullptr;
+    }
+
+    int uffd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+    if (uffd < 0) {
+        warn("Restoring '%s' eagerly, userfaultfd is not available: %s\n",
+             path, std::strerror(errno));
+        return nullptr;
+    }
+
+    uffdio_api api = {};
+    api.api = UFFD_API;
+    uffdio_register reg = {};
+    reg.range.start = reinterpret_cast<uint64_t>(pmem);
+    reg.range.len = roundUp(size, host_page_size);
+    reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+    const uint64_t needed = (1ULL << _UFFDIO_COPY) |
+        (1ULL << _UFFDIO_ZEROPAGE) | (1ULL << _UFFDIO_WAKE);
+    if (ioctl(uffd, UFFDIO_API, &api) ||
+        ioctl(uffd, UFFDIO_REGISTER, &reg) ||
+        (reg.ioctls & needed) != needed) {
+        warn("Restoring '%s' eagerly, its backing store cannot be "
+             "registered with userfaultfd: %s\n", path,
+             std::strerror(errno));
+        close(uffd);
+        return nullptr;
+    }
+
+    static std::once_flag at_fork;
+    std::call_once(at_fork, []() {
+        pthread_atfork(restoreAllBeforeFork, nullptr, nullptr);
+    });
+
+    std::unique_ptr<LazyRestore> restore(
+        new LazyRestore(path, pmem, size, host_page_size, uffd));
+    std::lock_guard<std::mutex> guard(activeLock);
+    active.insert(restore.get());
+    return restore;
+}
+
+LazyRestore::LazyRestore(const std::string &path, uint8_t *_pmem,
+                         uint64_t size, uint64_t host_page_size, int _uffd)
+    : reader(path), pmem(_pmem), mappedSize(roundUp(size, host_page_size)),
+      hostPageSize(host_page_size), uffd(_uffd),
+      stopFd(eventfd(0, EFD_CLOEXEC)), restored(reader.numChunks(), false),
+      buffer(chunked_store::chunkBytes)
+{
+    fatal_if(stopFd < 0, "Could not create an eventfd: %s\n",
+             std::strerror(errno));
+    handler = std::thread([this]() { serviceFaults(); });
+}
+
+LazyRestore::~LazyRestore()
+{
+    {
+        std::lock_guard<std::mutex> guard(activeLock);
+        active.erase(this);
+    }
+
+    uint64_t stop = 1;
+    panic_if(::write(stopFd, &stop, sizeof(stop)) != sizeof(stop),
+             "Could not stop the lazy restore of a backing store.");
+    handler.join();
+    close(stopFd);
+    close(uffd);
+}
+
+void
+LazyRestore::serviceFaults()
+{
+    pollfd fds[2] = {{uffd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+    while (true) {
+        int ret = poll(fds, 2, -1);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        panic_if(ret < 0, "Polling userfaultfd failed: %s",
+                 std::strerror(errno));
+        if (fds[1].revents)
+            return;
+
+        uffd_msg msg;
+        ssize_t bytes = read(uffd, &msg, sizeof(msg));
+        if (bytes < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        panic_if(bytes != sizeof(msg), "Reading userfaultfd failed: %s",
+                 std::strerror(errno));
+        if (msg.event != UFFD_EVENT_PAGEFAULT)
+            continue;
+
+        restoreChunk((msg.arg.pagefault.address -
+                      reinterpret_cast<uint64_t>(pmem)) /
+                     chunked_store::chunkBytes);
+    }
+}
+
+void
+LazyRestore::restoreChunk(uint64_t c)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    const uint64_t start = c * chunked_store::chunkBytes;
+    const uint64_t bytes =
+        std::min(chunked_store::chunkBytes, mappedSize - start);
+    const uint64_t dst = reinterpret_cast<uint64_t>(pmem) + start;
+
+    if (!restored[c]) {
+        restored[c] = true;
+
+        // all-zero chunks map the zero page, and take no host memory
+        const uint8_t *src = nullptr;
+        if (!reader.empty(c)) {
+            std::fill(buffer.begin(), buffer.end(), 0);
+            reader.readChunkInto(c, buffer.data());
+            src = buffer.data();
+        }
+
+        if (!fillRange(uffd, dst, src, bytes)) {
+            // some pages are already there, so fill in the others one
+            // at a time
+            for (uint64_t off = 0; off < bytes; off += hostPageSize)
+                fillRange(uffd, dst + off, src ? src + off : nullptr,
+                          hostPageSize);
+        }
+    }
+
+    // the fault may have raced with a restore that did not wake it
+    uffdio_range range = {dst, bytes};
+    ioctl(uffd, UFFDIO_WAKE, &range);
+}
+
+void
+LazyRestore::restoreAll()
+{
+    for (uint64_t c = 0; c < restored.size(); c++)
+        restoreChunk(c);
+}
+
+#else
+
+std::unique_ptr<LazyRestore>
+LazyRestore::create(const std::string &path, uint8_t *pmem, uint64_t size)
+{
+    warn("Restoring '%s' eagerly, the host has no userfaultfd.\n", path);
+    return nullptr;
+}
+
+LazyRestore::~LazyRestore()
+{
+}
+
+void
+LazyRestore::restoreAll()
+{
+}
+
+#endif
+
+} // namespace memory
+} // namespace gem5
@@ -0,0 +1,85 @@
+/* @file
+ * Restore of a backing store from a chunked store file on first touch
+ */
+
+#ifndef __MEM_LAZY_RESTORE_HH__
+#define __MEM_LAZY_RESTORE_HH__
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mem/chunked_store.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * Restores a backing store lazily. The store is registered with a
+ * userfaultfd, and a host thread restores each chunk of it from the
+ * chunked store file when any of its pages is first touched, either by
+ * the simulator or by a KVM guest. Chunks that are never touched are
+ * never decompressed, nor do they take any host memory.
+ *
+ * Before the simulator forks, all remaining chunks are restored, since
+ * the child would otherwise see them as zeros.
+ */
+class LazyRestore
+{
+  private:
+    const chunked_store::Reader reader;
+    uint8_t *const pmem;
+    const uint64_t mappedSize;
+    const uint64_t hostPageSize;
+
+    int uffd;
+    /** Event that stops the fault handler. */
+    int stopFd;
+
+    /** Serializes restores from the handler and before forks. */
+    std::mutex lock;
+    std::vector<bool> restored;
+    std::vector<uint8_t> buffer;
+
+    std::thread handler;
+
+    LazyRestore(const std::string &path, uint8_t *pmem, uint64_t size,
+                uint64_t host_page_size, int uffd);
+
+    void serviceFaults();
+
+    void restoreChunk(uint64_t chunk);
+
+  public:
+    /**
+     * Start restoring a backing store lazily.
+     *
+     * @param path Path of the chunked store file.
+     * @param pmem The host pointer to the backing store, which must not
+     *             have been touched yet.
+     * @param size Size of the backing store in bytes.
+     * @return The restore, or nullptr if the host cannot restore lazily,
+     *         in which case the store should be restored eagerly.
+     */
+    static std::unique_ptr<LazyRestore> create(const std::string &path,
+                                               uint8_t *pmem, uint64_t size);
+
+    ~LazyRestore();
+
+    LazyRestore(const LazyRestore &) = delete;
+    LazyRestore &operator=(const LazyRestore &) = delete;
+
+    /** Restore all chunks that have not been touched yet. */
+    void restoreAll();
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_LAZY_RESTORE_HH__
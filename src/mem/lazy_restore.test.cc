@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem/lazy_restore.hh"
+
+using namespace gem5::memory;
+
+namespace
+{
+
+const uint64_t storeSize = 3 * chunked_store::chunkBytes + 12345;
+
+class LazyRestoreTest : public ::testing::Test
+{
+  protected:
+    std::string path;
+    std::vector<uint8_t> store;
+    uint8_t *pmem = nullptr;
+
+    void
+    SetUp() override
+    {
+        // the second chunk only holds zeros
+        store.resize(storeSize, 0);
+        std::mt19937 rng(1);
+        for (uint64_t i = 0; i < chunked_store::chunkBytes; i += 3)
+            store[i] = rng();
+        for (uint64_t i = 2 * chunked_store::chunkBytes; i < storeSize;
+             i += 7) {
+            store[i] = i;
+        }
+
+        char name[] = "lazy-restore-XXXXXX";
+        int fd = mkstemp(name);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        path = name;
+        chunked_store::write(path, store.data(), store.size(), 2, false);
+
+        void *map = mmap(nullptr, storeSize, PROT_READ | PROT_WRITE,
+                         MAP_ANON | MAP_PRIVATE | MAP_NORESERVE, -1, 0);
+        ASSERT_NE(MAP_FAILED, map);
+        pmem = static_cast<uint8_t *>(map);
+    }
+
+    void
+    TearDown() override
+    {
+        if (pmem)
+            munmap(pmem, storeSize);
+        unlink(path.c_str());
+    }
+};
+
+} // anonymous namespace
+
+/** Touching the store restores it, whatever order it is touched in. */
+TEST_F(LazyRestoreTest, RestoresOnTouch)
+{
+    auto restore = LazyRestore::create(path, pmem, storeSize);
+    if (!restore)
+        GTEST_SKIP() << "userfaultfd is not available";
+
+    EXPECT_EQ(store[storeSize - 1], pmem[storeSize - 1]);
+    EXPECT_EQ(0, pmem[chunked_store::chunkBytes + 17]);
+
+    // writes to untouched pages land on top of the restored data
+    pmem[5] = 0xa5;
+    store[5] = 0xa5;
+
+    EXPECT_EQ(0, std::memcmp(store.data(), pmem, storeSize));
+}
+
+/** Restoring everything fills in the chunks that were not touched. */
+TEST_F(LazyRestoreTest, RestoreAll)
+{
+    auto restore = LazyRestore::create(path, pmem, storeSize);
+    if (!restore)
+        GTEST_SKIP() << "userfaultfd is not available";
+
+    EXPECT_EQ(store[0], pmem[0]);
+    restore->restoreAll();
+    restore.reset();
+
+    // with the restore gone, nothing can be faulted in any more
+    EXPECT_EQ(0, std::memcmp(store.data(), pmem, storeSize));
+}
@@ -200,6 +200,10 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     DPRINTF(NoncoherentXBar, "recvTimingResp: src %s %s 0x%x\n",
             src_port->name(), pkt->cmdString(), pkt->getAddr());
 
+    // remove the request from the routing table, before forwarding
+    // the packet may add new routes and invalidate the lookup
+    routeTo.erase(route_lookup);
+
     // store size and command as they might be modified when
     // forwarding the packet
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
@@ -221,9 +225,6 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     cpuSidePorts[cpu_side_port_id]->schedTimingResp(pkt,
                                         curTick() + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
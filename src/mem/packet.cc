@@ -53,6 +53,7 @@
 #include <sstream>
 #include <string>
 
+#include "base/binary_trace.hh"
 #include "base/cprintf.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -248,6 +249,23 @@ MemCmd::commandInfo[] =
     { {IsWrite, IsResponse}, InvalidCmd, "S2MNDR" }
 };
 
+namespace
+{
+
+// Name the commands in binary traces, after commandInfo is constructed
+struct BinaryTraceCmdNames
+{
+    BinaryTraceCmdNames()
+    {
+        for (int i = 0; i < MemCmd::NUM_MEM_CMDS; i++) {
+            MemCmd cmd((MemCmd::Command)i);
+            binary_trace::nameCmd(cmd.toInt(), cmd.toString());
+        }
+    }
+} binaryTraceCmdNames;
+
+} // anonymous namespace
+
 AddrRange
 Packet::getAddrRange() const
 {
@@ -58,6 +58,7 @@
 #include "base/extensible.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
@@ -359,7 +360,8 @@ class Packet : public Printable, public Extensible<Packet>
         STATIC_DATA            = 0x00001000,
         /// The data pointer points to a value that should be freed when
         /// the packet is destroyed. The pointer is assumed to be pointing
-        /// to an array, and delete [] is consequently called
+        /// to an array, and delete [] is consequently called, unless it
+        /// points to the inline storage of the packet
         DYNAMIC_DATA           = 0x00002000,
 
         /// suppress the error if this packet encounters a functional
@@ -396,6 +398,15 @@ class Packet : public Printable, public Extensible<Packet>
     */
     PacketDataPtr data;
 
+    /**
+     * Storage for payloads of up to a cache line, which saves an
+     * allocation for the common case of a packet moving a single
+     * block. The data pointer refers to it when the packet owns a
+     * small enough payload.
+     */
+    static constexpr unsigned inlineDataSize = 64;
+    alignas(16) uint8_t inlineData[inlineDataSize];
+
     /// The address of the request.  This address could be virtual or
     /// physical, depending on the system configuration.
     Addr addr;
@@ -1064,6 +1075,23 @@ class Packet : public Printable, public Extensible<Packet>
         deleteData();
     }
 
+    /**
+     * Packets are created and destroyed for every memory access, so
+     * they come from a per-thread pool rather than the host allocator.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        assert(size == sizeof(Packet));
+        return FixedSizePool<sizeof(Packet)>::allocate();
+    }
+
+    static void
+    operator delete(void *ptr)
+    {
+        FixedSizePool<sizeof(Packet)>::release(ptr);
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1372,7 +1400,7 @@ class Packet : public Printable, public Extensible<Packet>
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(DYNAMIC_DATA) && data != inlineData)
             delete [] data;
 
         flags.clear(STATIC_DATA|DYNAMIC_DATA);
@@ -1388,7 +1416,10 @@ class Packet : public Printable, public Extensible<Packet>
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            if (getSize() <= inlineDataSize)
+                data = inlineData;
+            else
+                data = new uint8_t[getSize()];
         }
     }
 
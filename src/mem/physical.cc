@@ -44,17 +44,22 @@
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/chunked_store.hh"
+#include "mem/host_pages.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_exit.hh"
 
@@ -80,10 +85,16 @@ PhysicalMemory::PhysicalMemory(const std::string& _name,
                                const std::vector<AbstractMemory*>& _memories,
                                bool mmap_using_noreserve,
                                const std::string& shared_backstore,
-                               bool auto_unlink_shared_backstore) :
+                               bool auto_unlink_shared_backstore,
+                               unsigned checkpoint_threads,
+                               bool lazy_restore,
+                               statistics::Group *stats_parent) :
     _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
     sharedBackstore(shared_backstore), sharedBackstoreSize(0),
-    pageSize(sysconf(_SC_PAGE_SIZE))
+    pageSize(sysconf(_SC_PAGE_SIZE)),
+    checkpointThreads(checkpoint_threads ? checkpoint_threads :
+                      std::max(1u, std::thread::hardware_concurrency())),
+    lazyRestore(lazy_restore), stats(stats_parent, *this)
 {
     // Register cleanup callback if requested.
     if (auto_unlink_shared_backstore && !sharedBackstore.empty()) {
@@ -232,9 +243,14 @@ PhysicalMemory::createBackingStore(
         map_flags = MAP_SHARED;
     }
 
+    const bool sparse = std::any_of(_memories.begin(), _memories.end(),
+        [](const AbstractMemory *m) { return m->isSparseBacking(); });
+    const bool dedup = std::any_of(_memories.begin(), _memories.end(),
+        [](const AbstractMemory *m) { return m->isDedupBacking(); });
+
     // to be able to simulate very large memories, the user can opt to
     // pass noreserve to mmap
-    if (mmapUsingNoReserve) {
+    if (mmapUsingNoReserve || sparse) {
         map_flags |= MAP_NORESERVE;
     }
 
@@ -248,11 +264,31 @@ PhysicalMemory::createBackingStore(
               range.to_string());
     }
 
+    if (sparse) {
+        // the host only allocates the pages that are written, and reads
+        // of the others map its zero page, but transparent huge pages
+        // would allocate much more than what is written
+        if (madvise(pmem, range.size(), MADV_NOHUGEPAGE) != 0) {
+            warn("Could not disable huge pages for the sparse backing "
+                 "store of range %s\n", range.to_string());
+        }
+    }
+
+    if (dedup) {
+        if (shm_fd != -1) {
+            warn("Pages of the shared backing store of range %s cannot "
+                 "be merged\n", range.to_string());
+        } else if (madvise(pmem, range.size(), MADV_MERGEABLE) != 0) {
+            warn("Could not let the host merge pages of the backing store "
+                 "of range %s: %s\n", range.to_string(), strerror(errno));
+        }
+    }
+
     // remember this backing store so we can checkpoint it and unmap
     // it appropriately
     backingStore.emplace_back(range, pmem,
                               conf_table_reported, in_addr_map, kvm_map,
-                              shm_fd, map_offset);
+                              shm_fd, map_offset, sparse);
 
     // point the memories to their backing store
     for (const auto& m : _memories) {
@@ -262,8 +298,65 @@ PhysicalMemory::createBackingStore(
     }
 }
 
+PhysicalMemory::BackingStoreStats::BackingStoreStats(
+        statistics::Group *parent, const PhysicalMemory &physmem)
+    : statistics::Group(parent, "backingStore"), physmem(physmem),
+      ADD_STAT(hostResident, statistics::units::Byte::get(),
+               "Host memory taken by the sparse backing store"),
+      ADD_STAT(hostProportional, statistics::units::Byte::get(),
+               "Host memory taken by the sparse backing store, with pages "
+               "merged with others counting in proportion")
+{
+}
+
+void
+PhysicalMemory::BackingStoreStats::regStats()
+{
+    statistics::Group::regStats();
+
+    using namespace statistics;
+
+    const size_t stores = std::max<size_t>(physmem.backingStore.size(), 1);
+    hostResident.init(stores).flags(nozero);
+    hostProportional.init(stores).flags(nozero);
+    for (size_t i = 0; i < physmem.backingStore.size(); i++) {
+        const std::string range = physmem.backingStore[i].range.to_string();
+        hostResident.subdesc(i, range);
+        hostProportional.subdesc(i, range);
+    }
+}
+
+void
+PhysicalMemory::BackingStoreStats::preDumpStats()
+{
+    statistics::Group::preDumpStats();
+
+    // asking the host is only worth it for sparse stores, which may be
+    // much larger than the host memory they take
+    std::vector<size_t> ids;
+    std::vector<std::pair<const void *, uint64_t>> ranges;
+    for (size_t i = 0; i < physmem.backingStore.size(); i++) {
+        const BackingStoreEntry &store = physmem.backingStore[i];
+        if (store.sparse) {
+            ids.push_back(i);
+            ranges.emplace_back(store.pmem, store.range.size());
+        }
+    }
+    if (ranges.empty())
+        return;
+
+    const std::vector<host_pages::Usage> usages = host_pages::usage(ranges);
+    for (size_t i = 0; i < ids.size(); i++) {
+        hostResident[ids[i]] = usages[i].resident;
+        hostProportional[ids[i]] = usages[i].proportional;
+    }
+}
+
 PhysicalMemory::~PhysicalMemory()
 {
+    // stop restoring before the stores go away
+    lazyRestores.clear();
+
     // unmap the backing store
     for (auto& s : backingStore)
         munmap((char*)s.pmem, s.range.size());
@@ -347,6 +440,10 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     SERIALIZE_CONTAINER(lal_addr);
     SERIALIZE_CONTAINER(lal_cid);
 
+    // pages still to be restored would look untouched, and thus zero
+    for (auto &lazy : lazyRestores)
+        lazy->restoreAll();
+
     // serialize the backing stores
     unsigned int nbr_of_stores = backingStore.size();
     SERIALIZE_SCALAR(nbr_of_stores);
@@ -355,19 +452,21 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     // store each backing store memory segment in a file
     for (auto& s : backingStore) {
         ScopedCheckpointSection sec(cp, csprintf("store%d", store_id));
-        serializeStore(cp, store_id++, s.range, s.pmem);
+        serializeStore(cp, store_id++, s.range, s.pmem, s.shmFd == -1);
     }
 }
 
 void
 PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
-                               AddrRange range, uint8_t* pmem) const
+                               AddrRange range, uint8_t* pmem,
+                               bool anonymous) const
 {
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
     std::string filename =
-        name() + ".store" + std::to_string(store_id) + ".pmem";
+        name() + ".store" + std::to_string(store_id) + ".chunks";
     long range_size = range.size();
+    std::string store_format = "chunked";
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
@@ -375,35 +474,12 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(store_format);
 
     // write memory file
     std::string filepath = CheckpointIn::dir() + "/" + filename.c_str();
-    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
-
-    uint64_t pass_size = 0;
-
-    // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
-
-        if (gzwrite(compressed_mem, pmem + written,
-                    (unsigned int) pass_size) != (int) pass_size) {
-            fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
-        }
-    }
-
-    // close the compressed stream and check that the exit status
-    // is zero
-    if (gzclose(compressed_mem))
-        fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
-
+    chunked_store::write(filepath, pmem, range.size(), checkpointThreads,
+                         anonymous);
 }
 
 void
@@ -434,8 +510,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -443,11 +517,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     std::string filepath = cp.getCptDir() + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -462,6 +531,43 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    // checkpoints without a format hold a gzipped image of the store
+    std::string store_format = "gz";
+    UNSERIALIZE_OPT_SCALAR(store_format);
+
+    if (store_format == "gz") {
+        unserializeGzStore(filepath, filename, pmem, range);
+    } else if (store_format == "chunked") {
+        chunked_store::Reader reader(filepath);
+        fatal_if(reader.size() != range.size(),
+                 "Physical memory checkpoint file '%s' holds %d bytes, "
+                 "expected %d\n", filename, reader.size(), range.size());
+        if (lazyRestore) {
+            auto lazy = LazyRestore::create(filepath, pmem, range.size());
+            if (lazy) {
+                lazyRestores.push_back(std::move(lazy));
+                return;
+            }
+        }
+        reader.readAll(pmem, checkpointThreads);
+    } else {
+        fatal("Unknown format '%s' of physical memory checkpoint file "
+              "'%s'\n", store_format, filename);
+    }
+}
+
+void
+PhysicalMemory::unserializeGzStore(const std::string &filepath,
+                                   const std::string &filename,
+                                   uint8_t *pmem, AddrRange range)
+{
+    const uint32_t chunk_size = 16384;
+
+    // mmap memoryfile
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -39,11 +39,14 @@
 #define __MEM_PHYSICAL_HH__
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "base/addr_range.hh"
 #include "base/addr_range_map.hh"
+#include "base/statistics.hh"
+#include "mem/lazy_restore.hh"
 #include "mem/packet.hh"
 #include "sim/serialize.hh"
 
@@ -71,10 +74,10 @@ class BackingStoreEntry
      */
     BackingStoreEntry(AddrRange range, uint8_t* pmem,
                       bool conf_table_reported, bool in_addr_map, bool kvm_map,
-                      int shm_fd=-1, off_t shm_offset=0)
+                      int shm_fd=-1, off_t shm_offset=0, bool sparse=false)
         : range(range), pmem(pmem), confTableReported(conf_table_reported),
           inAddrMap(in_addr_map), kvmMap(kvm_map), shmFd(shm_fd),
-          shmOffset(shm_offset)
+          shmOffset(shm_offset), sparse(sparse)
         {}
 
     /**
@@ -115,6 +118,12 @@ class BackingStoreEntry
       * of this backing store in the share memory. Otherwise, the value is 0.
       */
      off_t shmOffset;
+
+     /**
+      * Whether only the written pages of this backing store take host
+      * memory, as some of its memories asked for.
+      */
+     bool sparse;
 };
 
 /**
@@ -158,6 +167,15 @@ class PhysicalMemory : public Serializable
 
     long pageSize;
 
+    // Host threads that write and read the memory checkpoint files
+    const unsigned checkpointThreads;
+
+    // Restore chunked checkpoints on first touch rather than up front
+    const bool lazyRestore;
+
+    // Backing stores that are still being restored on first touch
+    std::vector<std::unique_ptr<LazyRestore>> lazyRestores;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -182,16 +200,30 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Restore a backing store from a gzipped image of the whole store,
+     * as written by older versions.
+     */
+    void unserializeGzStore(const std::string &filepath,
+                            const std::string &filename, uint8_t *pmem,
+                            AddrRange range);
+
   public:
 
     /**
      * Create a physical memory object, wrapping a number of memories.
+     *
+     * @param stats_parent The group the stats of the backing stores are
+     *                     reported in, if any
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
                    bool mmap_using_noreserve,
                    const std::string& shared_backstore,
-                   bool auto_unlink_shared_backstore);
+                   bool auto_unlink_shared_backstore,
+                   unsigned checkpoint_threads,
+                   bool lazy_restore,
+                   statistics::Group *stats_parent=nullptr);
 
     /**
      * Unmap all the backing store we have used.
@@ -275,14 +307,19 @@ class PhysicalMemory : public Serializable
     void serialize(CheckpointOut &cp) const override;
 
     /**
-     * Serialize a specific store.
+     * Serialize a specific store. The store is written as a chunked
+     * store file, which skips all-zero pages and is compressed and
+     * restored in parallel.
      *
      * @param store_id Unique identifier of this backing store
      * @param range The address range of this backing store
      * @param pmem The host pointer to this backing store
+     * @param anonymous Whether the store is a private anonymous mapping,
+     *                  whose untouched pages are known to be zero
      */
     void serializeStore(CheckpointOut &cp, unsigned int store_id,
-                        AddrRange range, uint8_t* pmem) const;
+                        AddrRange range, uint8_t* pmem,
+                        bool anonymous) const;
 
     /**
      * Unserialize the memories in the system. As with the
@@ -293,9 +330,33 @@ class PhysicalMemory : public Serializable
 
     /**
      * Unserialize a specific backing store, identified by a section.
+     * Both chunked store files and the gzipped images of older
+     * checkpoints are supported.
      */
     void unserializeStore(CheckpointIn &cp);
 
+    struct BackingStoreStats : public statistics::Group
+    {
+        BackingStoreStats(statistics::Group *parent,
+                          const PhysicalMemory &physmem);
+
+        void regStats() override;
+
+        /**
+         * Ask the host for the memory taken by the sparse backing
+         * stores, all at once, as each store may be shared by several
+         * memories.
+         */
+        void preDumpStats() override;
+
+        const PhysicalMemory &physmem;
+
+        /** Host memory taken by each sparse backing store */
+        statistics::Vector hostResident;
+        /** Host memory taken by each sparse backing store, net of
+         * merged pages */
+        statistics::Vector hostProportional;
+    } stats;
 };
 
 } // namespace memory
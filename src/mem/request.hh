@@ -60,6 +60,7 @@
 #include "base/compiler.hh"
 #include "base/extensible.hh"
 #include "base/flags.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
@@ -523,6 +524,21 @@ class Request : public Extensible<Request>
 
     ~Request() {}
 
+    /**
+     * Factory method for requests created on the memory hot path. The
+     * request and its reference count come from a per-thread pool,
+     * which is cheaper than std::make_shared when requests are created
+     * and destroyed at a high rate. Takes the same arguments as the
+     * constructors.
+     */
+    template <typename... Args>
+    static RequestPtr
+    create(Args&&... args)
+    {
+        return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                             std::forward<Args>(args)...);
+    }
+
     /**
      * Factory method for creating memory management requests, with
      * unspecified addr and size.
@@ -612,8 +628,8 @@ class Request : public Extensible<Request>
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = create(*this);
+        req2 = create(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
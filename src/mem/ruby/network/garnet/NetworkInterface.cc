@@ -635,8 +635,10 @@ NetworkInterface::checkReschedule()
         }
     }
 
-    for (auto& ni_out_vc : niOutVcs) {
-        if (ni_out_vc.isReady(clockEdge(Cycles(1)))) {
+    // A VC without credits waits for the credit link to wake us up
+    for (int vc = 0; vc < niOutVcs.size(); vc++) {
+        if (niOutVcs[vc].isReady(clockEdge(Cycles(1))) &&
+            outVcState[vc].has_credit()) {
             scheduleEvent(Cycles(1));
             return;
         }
@@ -32,6 +32,8 @@
 
 #include "mem/ruby/network/garnet/NetworkLink.hh"
 
+#include <algorithm>
+
 #include "base/trace.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet/CreditLink.hh"
@@ -104,8 +106,11 @@ NetworkLink::wakeup()
         m_vc_load[t_flit->get_vc()]++;
     }
 
+    // Sleep until the next flit is due rather than polling every
+    // cycle, flits from a NetworkBridge may be several cycles away
     if (!link_srcQueue->isEmpty()) {
-        scheduleEvent(Cycles(1));
+        Tick next_flit = link_srcQueue->peekTopFlit()->get_time();
+        scheduleEventAbsolute(std::max(clockEdge(Cycles(1)), next_flit));
     }
 }
 
@@ -353,6 +353,11 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 
 // Wakeup the router next cycle to perform SA again
 // if there are flits ready.
+// A flit that is already waiting for SA but is not allowed to send
+// (no free output VC or no credit) can only proceed once a credit
+// arrives, and the credit link wakes the router up in that cycle. Such
+// flits do not keep the router ticking, which is exact since a blocked
+// request does not move the round robin pointers.
 void
 SwitchAllocator::check_for_wakeup()
 {
@@ -363,8 +368,15 @@ SwitchAllocator::check_for_wakeup()
     }
 
     for (int i = 0; i < m_num_inports; i++) {
+        auto input_unit = m_router->getInputUnit(i);
         for (int j = 0; j < m_num_vcs; j++) {
-            if (m_router->getInputUnit(i)->need_stage(j, SA_, nextCycle)) {
+            if (!input_unit->need_stage(j, SA_, nextCycle)) {
+                continue;
+            }
+
+            if (!input_unit->need_stage(j, SA_, curTick()) ||
+                send_allowed(i, j, input_unit->get_outport(j),
+                             input_unit->get_outvc(j))) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
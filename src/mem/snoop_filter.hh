@@ -44,9 +44,9 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
 
+#include "base/flat_hash_map.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -96,7 +96,7 @@ class SnoopFilter : public SimObject
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
         linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
         maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
         stats(this)
@@ -221,9 +221,10 @@ class SnoopFilter : public SimObject
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * HashMap of SnoopItems indexed by line address. Kept flat, as it
+     * is looked up for every coherent transaction.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    typedef FlatHashMap<Addr, SnoopItem> SnoopFilterCache;
 
     /**
      * Simple factory methods for standard return values.
@@ -274,27 +275,20 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /**
+         * Line address of the entry lookupRequest used, if any. The
+         * entry is looked up again by finishRequest, as iterators of
+         * the cache do not survive insertions.
+         */
+        Addr lineAddr = 0;
+        bool valid = false;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -0,0 +1,67 @@
+#include "mem/weighted_interleave.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+WeightedInterleave::WeightedInterleave(const std::vector<unsigned> &weights,
+                                       Addr granularity)
+    : weights(weights), totalWeight(0),
+      granularityBits(floorLog2(granularity))
+{
+    assert(isPowerOf2(granularity));
+    for (unsigned weight : weights) {
+        firstStripe.push_back(totalWeight);
+        totalWeight += weight;
+    }
+    assert(totalWeight > 0);
+}
+
+WeightedInterleave::Location
+WeightedInterleave::map(Addr offset) const
+{
+    const Addr stripe = offset >> granularityBits;
+    const Addr round = stripe / totalWeight;
+    const unsigned index = stripe % totalWeight;
+
+    // the last target starting at or before the index, which skips the
+    // targets of weight zero
+    const unsigned target = std::upper_bound(firstStripe.begin(),
+                                             firstStripe.end(), index) -
+                            firstStripe.begin() - 1;
+    const Addr target_stripe =
+        round * weights[target] + index - firstStripe[target];
+
+    return {target, (target_stripe << granularityBits) |
+                    (offset & mask(granularityBits))};
+}
+
+Addr
+WeightedInterleave::unmap(const Location &location) const
+{
+    const Addr target_stripe = location.offset >> granularityBits;
+    const unsigned weight = weights[location.target];
+    const Addr stripe = target_stripe / weight * totalWeight +
+                        firstStripe[location.target] + target_stripe % weight;
+
+    return (stripe << granularityBits) |
+           (location.offset & mask(granularityBits));
+}
+
+Addr
+WeightedInterleave::targetBytes(unsigned target, Addr size) const
+{
+    assert(size % roundBytes() == 0);
+    return size / roundBytes() * (Addr(weights[target]) << granularityBits);
+}
+
+} // namespace memory
+} // namespace gem5
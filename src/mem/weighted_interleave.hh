@@ -0,0 +1,75 @@
+/* @file
+ * Weighted interleaving of an address range across several targets
+ */
+
+#ifndef __MEM_WEIGHTED_INTERLEAVE_HH__
+#define __MEM_WEIGHTED_INTERLEAVE_HH__
+
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * Stripes an address range across targets in proportion to their
+ * weights, as the weighted interleave policy of Linux does across NUMA
+ * nodes. The range is cut into stripes of a fixed granularity, and each
+ * round of stripes maps the first weight[0] stripes to target 0, the next
+ * weight[1] to target 1, and so on. Within each target the stripes it
+ * receives are packed contiguously.
+ */
+class WeightedInterleave
+{
+  public:
+    /** A target and an offset within it. */
+    struct Location
+    {
+        unsigned target;
+        Addr offset;
+    };
+
+    /**
+     * @param weights Number of consecutive stripes mapped to each target
+     *                in every round. A target of weight zero is unused.
+     * @param granularity Size of a stripe, a power of two.
+     */
+    WeightedInterleave(const std::vector<unsigned> &weights,
+                       Addr granularity);
+
+    /** Map an offset in the interleaved range to a target. */
+    Location map(Addr offset) const;
+
+    /** Map an offset within a target back to the interleaved range. */
+    Addr unmap(const Location &location) const;
+
+    /**
+     * Bytes of a target used by an interleaved range, whose size is a
+     * multiple of roundBytes().
+     */
+    Addr targetBytes(unsigned target, Addr size) const;
+
+    /** Bytes covered by one round of stripes. */
+    Addr roundBytes() const { return totalWeight << granularityBits; }
+
+    unsigned numTargets() const { return weights.size(); }
+
+  private:
+    std::vector<unsigned> weights;
+
+    /** Index of the first stripe of each target within a round. */
+    std::vector<unsigned> firstStripe;
+
+    unsigned totalWeight;
+
+    unsigned granularityBits;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_WEIGHTED_INTERLEAVE_HH__
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "mem/weighted_interleave.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+TEST(WeightedInterleaveTest, StripesInProportionToWeights)
+{
+    WeightedInterleave interleave({3, 1}, 4096);
+    EXPECT_EQ(4 * 4096, interleave.roundBytes());
+
+    std::vector<unsigned> stripes(2, 0);
+    for (Addr offset = 0; offset < 64 * 4096; offset += 4096)
+        ++stripes[interleave.map(offset).target];
+    EXPECT_EQ(48, stripes[0]);
+    EXPECT_EQ(16, stripes[1]);
+
+    EXPECT_EQ(48 * 4096, interleave.targetBytes(0, 64 * 4096));
+    EXPECT_EQ(16 * 4096, interleave.targetBytes(1, 64 * 4096));
+}
+
+TEST(WeightedInterleaveTest, PacksStripesWithinTargets)
+{
+    WeightedInterleave interleave({2, 1}, 256);
+
+    // the second round starts with the third stripe of target 0
+    auto location = interleave.map(3 * 256 + 17);
+    EXPECT_EQ(0, location.target);
+    EXPECT_EQ(2 * 256 + 17, location.offset);
+
+    location = interleave.map(5 * 256 + 255);
+    EXPECT_EQ(1, location.target);
+    EXPECT_EQ(256 + 255, location.offset);
+}
+
+TEST(WeightedInterleaveTest, SkipsTargetsOfWeightZero)
+{
+    WeightedInterleave interleave({1, 0, 2}, 64);
+
+    EXPECT_EQ(0, interleave.map(0).target);
+    EXPECT_EQ(2, interleave.map(64).target);
+    EXPECT_EQ(2, interleave.map(128).target);
+    EXPECT_EQ(0, interleave.targetBytes(1, 3 * 64));
+}
+
+TEST(WeightedInterleaveTest, UnmapsWhatItMaps)
+{
+    WeightedInterleave interleave({5, 3, 2}, 128);
+
+    for (Addr offset = 0; offset < 100 * 128; offset += 8) {
+        auto location = interleave.map(offset);
+        EXPECT_EQ(offset, interleave.unmap(location));
+        EXPECT_LT(location.offset,
+                  interleave.targetBytes(location.target, 100 * 128));
+    }
+}
@@ -47,9 +47,9 @@
 #define __MEM_XBAR_HH__
 
 #include <deque>
-#include <unordered_map>
 
 #include "base/addr_range_map.hh"
+#include "base/flat_hash_map.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
 #include "params/BaseXBar.hh"
@@ -322,9 +322,10 @@ class BaseXBar : public ClockedObject
      * Remember where request packets came from so that we can route
      * responses to the appropriate port. This relies on the fact that
      * the underlying Request pointer inside the Packet stays
-     * constant.
+     * constant. Every transaction through the crossbar adds and
+     * removes an entry, so the table is a flat map.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    FlatHashMap<RequestPtr, PortID> routeTo;
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
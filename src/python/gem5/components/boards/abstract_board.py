@@ -80,8 +80,8 @@ class AbstractBoard:
         processor: "AbstractProcessor",
         memory: "AbstractMemorySystem",
         cache_hierarchy: Optional["AbstractCacheHierarchy"],
-        cxl_memory: "AbstractMemorySystem",
-        is_asic: bool
+        cxl_memory: Optional["AbstractMemorySystem"] = None,
+        is_asic: bool = True,
     ) -> None:
         """
         :param clk_freq: The clock frequency for this board.
@@ -90,6 +90,10 @@ class AbstractBoard:
         :param cache_hierarchy: The Cache Hierarchy for this board.
                                 In some boards caches can be optional. If so,
                                 that board must override ``_connect_things``.
+        :param cxl_memory: The memory behind the CXL device, if the board
+                           has one.
+        :param is_asic: Whether the CXL device is an ASIC rather than an
+                        FPGA.
         """
 
         if not isinstance(self, System):
@@ -108,7 +112,9 @@ class AbstractBoard:
             self.cache_hierarchy = cache_hierarchy
 
         # Set the CXL memory size and whether the device is an ASIC or not.
-        self.cxl_memory = cxl_memory
+        self._cxl_memory = cxl_memory
+        if cxl_memory is not None:
+            self.cxl_memory = cxl_memory
         self._is_asic = is_asic
         # This variable determines whether the board is to be executed in
         # full-system or syscall-emulation mode. This is set when the workload
@@ -150,7 +156,7 @@ class AbstractBoard:
 
         :returns: The memory system.
         """
-        return self.cxl_memory
+        return self._cxl_memory
 
     def get_mem_ports(self) -> Sequence[Tuple[AddrRange, Port]]:
         """Get the memory ports exposed on this board
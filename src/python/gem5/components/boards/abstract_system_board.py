@@ -25,6 +25,7 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from abc import ABCMeta
+from typing import Optional
 
 from m5.objects import (
     SimObject,
@@ -49,8 +50,8 @@ class AbstractSystemBoard(System, AbstractBoard):
         processor: "AbstractProcessor",
         memory: "AbstractMemorySystem",
         cache_hierarchy: "AbstractCacheHierarchy",
-        cxl_memory: "AbstractMemorySystem",
-        is_asic: bool
+        cxl_memory: Optional["AbstractMemorySystem"] = None,
+        is_asic: bool = True,
     ):
         System.__init__(self)
         AbstractBoard.__init__(
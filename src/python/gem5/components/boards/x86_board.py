@@ -27,9 +27,11 @@
 
 from typing import (
     List,
+    Optional,
     Sequence,
 )
 
+import m5
 from m5.objects import (
     Addr,
     AddrRange,
@@ -82,7 +84,31 @@ class X86Board(AbstractSystemBoard, KernelDiskWorkload):
         cache_hierarchy: AbstractCacheHierarchy,
         cxl_memory: AbstractMemorySystem,
         is_asic: bool,
+        cxl_eventq_index: Optional[int] = None,
+        cxl_sparse_backing: bool = False,
+        cxl_dedup_backing: bool = False,
     ) -> None:
+        """
+        :param cxl_eventq_index: If set, the CXL device and its memory are
+                                 simulated on this event queue, i.e. by a
+                                 separate host thread, behind a dedicated
+                                 CXLBridge. The simulation quantum is then
+                                 bounded by the bridge latency. CXL
+                                 accesses take the same bridge and I/O
+                                 crossbar as without it, but the rest of
+                                 the I/O no longer shares them, so it
+                                 does not contend with CXL accesses.
+        :param cxl_sparse_backing: Only back the pages of the CXL memory
+                                   that are written with host memory, so
+                                   that CXL pools much larger than the host
+                                   memory can be simulated.
+        :param cxl_dedup_backing: Let the host merge identical pages of the
+                                  sparse CXL backing store.
+        """
+        self._cxl_eventq_index = cxl_eventq_index
+        self._cxl_sparse_backing = cxl_sparse_backing
+        self._cxl_dedup_backing = cxl_dedup_backing
+
         super().__init__(
             clk_freq=clk_freq,
             processor=processor,
@@ -137,34 +163,84 @@ class X86Board(AbstractSystemBoard, KernelDiskWorkload):
             interrupts_address_space_base = 0xA000000000000000
             APIC_range_size = 1 << 12
 
-            # Configure CXLBridge
-            self.bridge = CXLBridge(bridge_lat="50ns", proto_proc_lat="12ns", req_fifo_depth=128, resp_fifo_depth=128)
-            self.bridge.mem_side_port = self.get_io_bus().cpu_side_ports
-            self.bridge.cpu_side_port = (
-                self.get_cache_hierarchy().get_mem_side_port()
-            )
+            # Configure CXL Device
+            cxl_mem_start = 0x100000000
+            cxl_dram = self.get_cxl_memory()
+            cxl_mem_range = AddrRange(Addr(cxl_mem_start), size=cxl_dram.get_size())
+            self.pc.south_bridge.cxlmemory.cxl_mem_range = cxl_mem_range
+            cxl_ctrl_reg_range = AddrRange(0xFE000000, size="64kB")
+            self.pc.south_bridge.cxlmemory.ctrl_reg_range = cxl_ctrl_reg_range
 
-            self.bridge.ranges = [
-                AddrRange(0xC0000000, 0xFFFF0000),
+            io_ranges = [
                 AddrRange(
                     IO_address_space_base, interrupts_address_space_base - 1
                 ),
                 AddrRange(pci_config_address_space_base, Addr.max),
             ]
 
-            # Configure CXL Device
-            cxl_mem_start = 0x100000000
-            cxl_dram = self.get_cxl_memory()
-            cxl_mem_range = AddrRange(Addr(cxl_mem_start), size=cxl_dram.get_size())
-            self.bridge.ranges.append(cxl_mem_range)
-            self.pc.south_bridge.cxlmemory.cxl_mem_range = cxl_mem_range
+            if self._cxl_eventq_index is None:
+                # Configure CXLBridge
+                self.bridge = CXLBridge(bridge_lat="50ns", proto_proc_lat="12ns", req_fifo_depth=128, resp_fifo_depth=128)
+                self.bridge.mem_side_port = self.get_io_bus().cpu_side_ports
+                self.bridge.cpu_side_port = (
+                    self.get_cache_hierarchy().get_mem_side_port()
+                )
+                self.bridge.ranges = [
+                    AddrRange(0xC0000000, 0xFFFF0000)
+                ] + io_ranges + [cxl_mem_range]
+            else:
+                # The CXL device, its memory bus and its memory run on
+                # their own event queue. They get a dedicated CXLBridge,
+                # which is the only path between the two queues, and an
+                # I/O crossbar of their own like the one the device is
+                # behind otherwise. The rest of the I/O goes through a
+                # plain bridge with the same latency.
+                self.bridge = Bridge(delay="50ns", req_size=128, resp_size=128)
+                self.bridge.mem_side_port = self.get_io_bus().cpu_side_ports
+                self.bridge.cpu_side_port = (
+                    self.get_cache_hierarchy().get_mem_side_port()
+                )
+                self.bridge.ranges = [
+                    AddrRange(0xC0000000, cxl_ctrl_reg_range.start),
+                    AddrRange(cxl_ctrl_reg_range.end, 0xFFFF0000),
+                ] + io_ranges
+
+                self.cxl_bridge = CXLBridge(
+                    bridge_lat="50ns",
+                    proto_proc_lat="12ns",
+                    req_fifo_depth=128,
+                    resp_fifo_depth=128,
+                    mem_side_eventq_index=self._cxl_eventq_index,
+                )
+                self.cxl_bridge.cpu_side_port = (
+                    self.get_cache_hierarchy().get_mem_side_port()
+                )
+                self.cxl_bridge.ranges = [cxl_ctrl_reg_range, cxl_mem_range]
+
+                self.cxl_iobus = IOXBar()
+                self.cxl_iobus.eventq_index = self._cxl_eventq_index
+                self.cxl_bridge.mem_side_port = self.cxl_iobus.cpu_side_ports
+                self.pc.south_bridge.cxlmemory.cxl_rsp_port = (
+                    self.cxl_iobus.mem_side_ports
+                )
+
+                self.pc.south_bridge.cxlmemory.eventq_index = (
+                    self._cxl_eventq_index
+                )
+                cxl_dram.eventq_index = self._cxl_eventq_index
+
             cxl_dram.set_memory_range([cxl_mem_range])
             cxl_abstract_mems = []
             for mc in cxl_dram.get_memory_controllers():
+                mc.dram.sparse_backing = self._cxl_sparse_backing
+                mc.dram.dedup_backing = self._cxl_dedup_backing
                 cxl_abstract_mems.append(mc.dram)
             self.memories.extend(cxl_abstract_mems)
             self.cxl_mem_bus = CXLMemBar()
+            if self._cxl_eventq_index is not None:
+                self.cxl_mem_bus.eventq_index = self._cxl_eventq_index
             self.cxl_mem_bus.cpu_side_ports = self.pc.south_bridge.cxlmemory.mem_req_port
+            self.cxl_mem_bus.cpu_side_ports = self.pc.south_bridge.cxlmemory.nmp_port
             for _, port in cxl_dram.get_mem_ports():
                 self.cxl_mem_bus.mem_side_ports = port
 
@@ -286,10 +362,40 @@ class X86Board(AbstractSystemBoard, KernelDiskWorkload):
             X86E820Entry(addr=0xFFFF0000, size="64kB", range_type=2)
         )
 
+        # Reserve the CXL device control registers
+        entries.append(
+            X86E820Entry(
+                addr=cxl_ctrl_reg_range.start,
+                size=f"{cxl_ctrl_reg_range.size()}B",
+                range_type=2,
+            )
+        )
+
         entries.append(X86E820Entry(addr=0x100000000, size=f"{cxl_mem_range.size()}B", range_type=1))
 
         self.workload.e820_table.entries = entries
 
+    def get_eventq_indices(self) -> List[int]:
+        """
+        The event queues, other than the first, the board simulates parts
+        of itself on. Other components, e.g. KVM cores, should use others.
+        """
+        if self._cxl_eventq_index is None:
+            return []
+        return [self._cxl_eventq_index]
+
+    def get_sim_quantum(self) -> Optional[int]:
+        """
+        The simulation quantum, in ticks, needed when the CXL device is
+        simulated on its own event queue, None otherwise. The quantum may
+        not exceed the latency of the CXLBridge between the queues.
+        """
+        if self._cxl_eventq_index is None:
+            return None
+
+        m5.ticks.fixGlobalFrequency()
+        return self.cxl_bridge.bridge_lat.getValue()
+
     @overrides(AbstractSystemBoard)
     def has_io_bus(self) -> bool:
         return True
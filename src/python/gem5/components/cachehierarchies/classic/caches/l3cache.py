@@ -28,6 +28,7 @@ from typing import Type
 
 from m5.objects import (
     BasePrefetcher,
+    BaseSetAssoc,
     Cache,
     Clusivity,
     L2MultiPrefetcher,
@@ -54,6 +55,7 @@ class L3Cache(Cache):
         writeback_clean: bool = False,
         clusivity: Clusivity = "mostly_excl",
         PrefetcherCls: Type[BasePrefetcher] = L2MultiPrefetcher,
+        vector_tag_lookup: bool = False,
     ):
         super().__init__()
         self.size = size
@@ -67,3 +69,6 @@ class L3Cache(Cache):
         self.writeback_clean = writeback_clean
         self.clusivity = clusivity
         self.prefetcher = PrefetcherCls()
+
+        if vector_tag_lookup:
+            self.tags = BaseSetAssoc(vector_tag_lookup=True)
@@ -83,6 +83,7 @@ class PrivateL1PrivateL2SharedL3CacheHierarchy(
         l2_assoc: int = 16,
         l3_assoc: int = 16,
         membus: BaseXBar = _get_default_membus.__func__(),
+        l3_vector_tag_lookup: bool = False,
     ) -> None:
         """
         :param l1d_size: The size of the L1 Data Cache (e.g., "32kB").
@@ -95,6 +96,9 @@ class PrivateL1PrivateL2SharedL3CacheHierarchy(
         :param l3_assoc: The associativity of the L3 Cache.
         :param membus: The memory bus. This parameter is optional parameter and
                        will default to a 64 bit width SystemXBar is not specified.
+        :param l3_vector_tag_lookup: Whether the L3 Cache looks its tags up
+                                     in a vectorized tag array, which needs
+                                     at most 64 ways.
         """
 
         AbstractClassicCacheHierarchy.__init__(self=self)
@@ -111,6 +115,7 @@ class PrivateL1PrivateL2SharedL3CacheHierarchy(
         )
 
         self.membus = membus
+        self._l3_vector_tag_lookup = l3_vector_tag_lookup
 
     @overrides(AbstractClassicCacheHierarchy)
     def get_mem_side_port(self) -> Port:
@@ -148,7 +153,11 @@ class PrivateL1PrivateL2SharedL3CacheHierarchy(
             for i in range(board.get_processor().get_num_cores())
         ]
         self.l3bus = L3XBar()
-        self.l3cache = L3Cache(size=self._l3_size, assoc=self._l3_assoc)
+        self.l3cache = L3Cache(
+            size=self._l3_size,
+            assoc=self._l3_assoc,
+            vector_tag_lookup=self._l3_vector_tag_lookup,
+        )
         # ITLB Page walk caches
         self.iptw_caches = [
             MMUCache(size="256KiB", writeback_clean=False)
@@ -0,0 +1,100 @@
+"""
+A memory system behind a CXL memory device.
+"""
+
+from typing import (
+    List,
+    Optional,
+    Sequence,
+    Tuple,
+)
+
+from m5.objects import (
+    AddrRange,
+    CXLBridge,
+    CXLMemBar,
+    IOXBar,
+    MemCtrl,
+    Pc,
+    Port,
+)
+
+from ...utils.override import overrides
+from ..boards.abstract_board import AbstractBoard
+from .abstract_memory_system import AbstractMemorySystem
+
+
+class CXLExpander(AbstractMemorySystem):
+    """
+    A memory system, typically DRAM, behind a CXL memory device and reached
+    through a CXLBridge, for boards without a PC platform of their own.
+
+    The device is the one on the south bridge of a PC platform, which also
+    provides the PCI host it needs, and the platform gets a private I/O bus.
+    The only port of the expander is the CPU side of the bridge, so it can
+    be connected to a board directly or put behind other components, such as
+    an interleaver.
+    """
+
+    def __init__(
+        self,
+        memory: AbstractMemorySystem,
+        ctrl_reg_range: Optional[AddrRange] = None,
+    ) -> None:
+        """
+        :param memory: The memory behind the device.
+        :param ctrl_reg_range: Where the control registers of the device are,
+                               if not at their default address. The bridge
+                               forwards them, so they must not overlap other
+                               memory on the same side of the bridge.
+        """
+        super().__init__()
+        self._dram = memory
+        self.dram = self._dram
+
+        self.pc = Pc()
+        self._device = self.pc.south_bridge.cxlmemory
+        self._device.BAR0.size = self._dram.get_size_str()
+        if ctrl_reg_range is not None:
+            self._device.ctrl_reg_range = ctrl_reg_range
+
+        self.bridge = CXLBridge(
+            bridge_lat="50ns",
+            proto_proc_lat="12ns",
+            req_fifo_depth=128,
+            resp_fifo_depth=128,
+        )
+        self.bridge.mem_side_port = self._device.cxl_rsp_port
+
+        self.cxl_mem_bus = CXLMemBar()
+        self.cxl_mem_bus.cpu_side_ports = self._device.mem_req_port
+        self.cxl_mem_bus.cpu_side_ports = self._device.nmp_port
+        for _, port in self._dram.get_mem_ports():
+            self.cxl_mem_bus.mem_side_ports = port
+
+        self.iobus = IOXBar()
+        self.pc.attachIO(self.iobus)
+
+    @overrides(AbstractMemorySystem)
+    def incorporate_memory(self, board: AbstractBoard) -> None:
+        self._dram.incorporate_memory(board)
+
+    @overrides(AbstractMemorySystem)
+    def get_mem_ports(self) -> Sequence[Tuple[AddrRange, Port]]:
+        return [(self._device.cxl_mem_range, self.bridge.cpu_side_port)]
+
+    @overrides(AbstractMemorySystem)
+    def get_memory_controllers(self) -> List[MemCtrl]:
+        return self._dram.get_memory_controllers()
+
+    @overrides(AbstractMemorySystem)
+    def get_size(self) -> int:
+        return self._dram.get_size()
+
+    @overrides(AbstractMemorySystem)
+    def set_memory_range(self, ranges: List[AddrRange]) -> None:
+        if len(ranges) != 1:
+            raise Exception("CXLExpander only supports a single range.")
+        self._dram.set_memory_range(ranges)
+        self._device.cxl_mem_range = ranges[0]
+        self.bridge.ranges = [ranges[0], self._device.ctrl_reg_range]
@@ -25,12 +25,17 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
+import itertools
 from typing import (
     Dict,
     List,
+    Optional,
+    Tuple,
 )
 
 import m5
+import m5.params
+from m5.util import warn
 
 from ...utils.override import *
 from ..boards.abstract_board import AbstractBoard
@@ -84,6 +89,65 @@ class SwitchableProcessor(AbstractProcessor):
 
             self.kvm_vm = KvmVM()
 
+        self._sim_quanta: Optional[Tuple[int, int]] = None
+
+    def set_kvm_cache_warming(self, pages: int, period: str = "1ms") -> None:
+        """
+        Warm the caches when switching from KVM cores to cores that use
+        them. While the KVM cores run, the VM logs the guest pages written
+        recently, and these are read through the caches before the switch,
+        so that the caches start with the recently used data instead of
+        cold. The lines are installed clean, as KVM writes the memory
+        directly.
+
+        Only the pages written by the guest are logged, as reads cannot be
+        tracked cheaply under KVM, and which core wrote a page is unknown,
+        so the pages are spread over the cores. The warming is skipped
+        with Ruby, which does not support atomic accesses.
+
+        :param pages: The number of recently written pages to track. This
+                      should cover the capacity of the caches.
+        :param period: How often the written pages are fetched from KVM,
+                       which is the resolution at which they are ordered.
+        """
+        if not self._prepare_kvm:
+            raise AssertionError(
+                "Cache warming from KVM needs KVM cores in the processor."
+            )
+        self.kvm_vm.dirty_log_pages = pages
+        self.kvm_vm.dirty_log_period = period
+
+    def _set_sim_quanta(self, kvm_quantum: int, quantum: int) -> None:
+        """
+        Switch the simulation quantum along with the cores. KVM cores only
+        run at near native speed with a long quantum, while the other cores
+        may need a much shorter one, e.g. when their memory system spans
+        several event queues. This is set by the Simulator.
+
+        :param kvm_quantum: The quantum, in ticks, while KVM cores run.
+        :param quantum: The quantum, in ticks, while the other cores run.
+        """
+        self._sim_quanta = (kvm_quantum, quantum)
+
+    def _warm_caches(self, to_switch: List[SimpleCore]) -> None:
+        """Warm the caches before switching from KVM cores, if enabled."""
+        if (
+            not self._prepare_kvm
+            or not self.kvm_vm.dirty_log_pages
+            or not all(core.is_kvm_core() for core in self._current_cores)
+            or any(core.is_kvm_core() for core in to_switch)
+        ):
+            return
+        if self._board.get_cache_hierarchy().is_ruby():
+            warn("Caches are not warmed from KVM with Ruby.")
+            return
+
+        m5.drain()
+        memory_mode = m5.params.allEnums["MemoryMode"]("atomic").getValue()
+        self._board.setMemoryMode(memory_mode)
+        for core in self._current_cores:
+            core.get_simobject().warmCaches()
+
     @overrides(AbstractProcessor)
     def incorporate_processor(self, board: AbstractBoard) -> None:
         # This is a bit of a hack. The `m5.switchCpus` function, used in the
@@ -98,10 +162,16 @@ class SwitchableProcessor(AbstractProcessor):
             kvm_cores = [
                 core for core in self._all_cores() if core.is_kvm_core()
             ]
-            for i, core in enumerate(kvm_cores):
+            # The event queues the board already simulates parts of itself
+            # on, e.g. its CXL device, are left to those.
+            reserved = set()
+            if hasattr(board, "get_eventq_indices"):
+                reserved.update(board.get_eventq_indices())
+            indices = (i for i in itertools.count(1) if i not in reserved)
+            for core, index in zip(kvm_cores, indices):
                 for obj in core.get_simobject().descendants():
                     obj.eventq_index = 0
-                core.get_simobject().eventq_index = i + 1
+                core.get_simobject().eventq_index = index
 
     @overrides(AbstractProcessor)
     def get_num_cores(self) -> int:
@@ -143,6 +213,8 @@ class SwitchableProcessor(AbstractProcessor):
                 "already swapped in. This is not allowed."
             )
 
+        self._warm_caches(to_switch)
+
         current_core_simobj = [
             core.get_simobject() for core in self._current_cores
         ]
@@ -155,3 +227,11 @@ class SwitchableProcessor(AbstractProcessor):
 
         # Ensure the current processor is updated.
         self._current_cores = to_switch
+
+        if self._sim_quanta:
+            kvm_quantum, quantum = self._sim_quanta
+            m5.setSimQuantum(
+                kvm_quantum
+                if any(core.is_kvm_core() for core in to_switch)
+                else quantum
+            )
@@ -0,0 +1,229 @@
+"""
+Sampled simulation in the style of SMARTS.
+
+The simulation is cut into periods of equal length. Each period starts
+with a fast-forward on warming cores, typically atomic cores, which keep
+the caches and the memory system warm. The last part of each period runs
+on detailed cores: a short detailed warm-up, which fills the pipelines and
+queues, followed by the measured interval. The measured intervals are
+independent samples of the whole run, so the mean of each metric over
+them comes with a confidence interval.
+
+All lengths are in ticks rather than instructions, so that samples of
+multi-core runs stay aligned across cores.
+"""
+
+import json
+import math
+import statistics
+from pathlib import Path
+from typing import (
+    Callable,
+    Dict,
+    Generator,
+    List,
+    Optional,
+)
+
+import m5
+import m5.stats
+from m5.objects import Root
+from m5.util import inform
+
+from ..components.processors.switchable_processor import SwitchableProcessor
+
+
+def _root_stat(name: str) -> float:
+    """Return the value of a stat of the root, such as simInsts."""
+    for stat in Root.getInstance().getStats():
+        if stat.name == name:
+            value = stat.result
+            return value[0] if isinstance(value, list) else value
+    raise KeyError(f"No root stat named '{name}'")
+
+
+class SampledMetric:
+    """The samples of one metric, and their mean with its confidence."""
+
+    def __init__(self, name: str, confidence: float) -> None:
+        self.name = name
+        self.confidence = confidence
+        self.samples: List[float] = []
+
+    def mean(self) -> float:
+        return statistics.fmean(self.samples) if self.samples else math.nan
+
+    def stdev(self) -> float:
+        if len(self.samples) < 2:
+            return math.nan
+        return statistics.stdev(self.samples)
+
+    def interval(self) -> float:
+        """
+        Half-width of the confidence interval of the mean, under the normal
+        approximation SMARTS relies on, which needs a few tens of samples.
+        """
+        if len(self.samples) < 2:
+            return math.nan
+        z = statistics.NormalDist().inv_cdf(0.5 + self.confidence / 2)
+        return z * self.stdev() / math.sqrt(len(self.samples))
+
+    def to_json(self) -> Dict:
+        mean = self.mean()
+        interval = self.interval()
+        return {
+            "mean": mean,
+            "stdev": self.stdev(),
+            "confidence": self.confidence,
+            "interval": interval,
+            "relative_error": interval / abs(mean) if mean else math.nan,
+            "samples": self.samples,
+        }
+
+
+class SmartsSampler:
+    """
+    Alternates between fast-forwarding on warming cores and measuring on
+    detailed cores, and estimates metrics over the measured intervals.
+
+    Use it through ``Simulator.schedule_sampling()``. The sampler takes over
+    the ``SCHEDULED_TICK`` exit event, so the run must not schedule tick
+    exits of its own. Once all samples are taken, the run loop exits and the
+    estimates are written to ``sampling.json`` in the output directory.
+
+    Each sample always measures ``ips``, the simulated instructions per
+    simulated second across all cores. Other metrics are functions called
+    at the end of each measured interval. The stats are reset at the start
+    of each measured interval, so these can read the stats of the interval,
+    e.g. the mean latency of the CXL bridge.
+
+    The warming cores have to warm the caches, so with Ruby, whose caches
+    are skipped by atomic accesses, they should be timing cores.
+    """
+
+    def __init__(
+        self,
+        processor: SwitchableProcessor,
+        period: int,
+        detailed_warmup: int,
+        measurement: int,
+        num_samples: int,
+        warming_cores: str = "start",
+        detailed_cores: str = "switch",
+        metrics: Optional[Dict[str, Callable[[], float]]] = None,
+        confidence: float = 0.95,
+        dump_stats: bool = True,
+    ) -> None:
+        """
+        :param processor: The processor holding both sets of cores, which
+                          must start on the warming cores.
+        :param period: Ticks from the start of one sample to the next.
+        :param detailed_warmup: Ticks of detailed simulation before each
+                                measured interval.
+        :param measurement: Ticks of each measured interval.
+        :param num_samples: Number of samples after which the run loop
+                            exits.
+        :param warming_cores: Name of the cores of the processor used to
+                              fast-forward.
+        :param detailed_cores: Name of the cores of the processor used to
+                               measure.
+        :param metrics: Functions returning the metrics of each sample,
+                        keyed by metric name.
+        :param confidence: Confidence level of the intervals.
+        :param dump_stats: Whether to dump the stats of each measured
+                           interval.
+        """
+        if detailed_warmup + measurement >= period:
+            raise ValueError(
+                "The detailed warm-up and the measured interval must be "
+                "shorter than the sampling period."
+            )
+        if num_samples <= 0:
+            raise ValueError("At least one sample must be taken.")
+
+        self._processor = processor
+        self._period = period
+        self._detailed_warmup = detailed_warmup
+        self._measurement = measurement
+        self._num_samples = num_samples
+        self._warming_cores = warming_cores
+        self._detailed_cores = detailed_cores
+        self._metric_functions = metrics or {}
+        self._dump_stats = dump_stats
+
+        self._metrics = {
+            name: SampledMetric(name, confidence)
+            for name in ["ips"] + list(self._metric_functions)
+        }
+
+    def get_metrics(self) -> Dict[str, SampledMetric]:
+        """The metrics sampled so far, keyed by name."""
+        return self._metrics
+
+    def _start(self) -> None:
+        """Schedule the end of the first fast-forward."""
+        m5.scheduleTickExitFromCurrent(
+            self._period - self._detailed_warmup - self._measurement
+        )
+
+    def _switch_to(self, cores: str) -> None:
+        if self._processor._current_cores is not (
+            self._processor._switchable_cores[cores]
+        ):
+            self._processor.switch_to_processor(cores)
+
+    def _take_sample(self, start_insts: float, start_tick: int) -> None:
+        seconds = (m5.curTick() - start_tick) / m5.ticks.getFrequency()
+        insts = _root_stat("simInsts") - start_insts
+        self._metrics["ips"].samples.append(insts / seconds)
+        for name, function in self._metric_functions.items():
+            self._metrics[name].samples.append(function())
+
+        if self._dump_stats:
+            m5.stats.dump()
+
+    def _write_report(self) -> None:
+        report = {
+            "period": self._period,
+            "detailed_warmup": self._detailed_warmup,
+            "measurement": self._measurement,
+            "metrics": {
+                name: metric.to_json()
+                for name, metric in self._metrics.items()
+            },
+        }
+        path = Path(m5.options.outdir) / "sampling.json"
+        with open(path, "w") as report_file:
+            json.dump(report, report_file, indent=2)
+
+        for name, metric in self._metrics.items():
+            inform(
+                f"{name}: {metric.mean():g} +/- {metric.interval():g} "
+                f"({metric.confidence:.0%} confidence, "
+                f"{len(metric.samples)} samples)"
+            )
+
+    def _run(self) -> Generator[bool, None, None]:
+        """The ``SCHEDULED_TICK`` exit event generator."""
+        for sample in range(self._num_samples):
+            # end of the fast-forward
+            self._switch_to(self._detailed_cores)
+            m5.scheduleTickExitFromCurrent(self._detailed_warmup)
+            yield False
+
+            # end of the detailed warm-up
+            m5.stats.reset()
+            start_insts = _root_stat("simInsts")
+            start_tick = m5.curTick()
+            m5.scheduleTickExitFromCurrent(self._measurement)
+            yield False
+
+            # end of the measured interval
+            self._take_sample(start_insts, start_tick)
+            self._switch_to(self._warming_cores)
+            if sample + 1 < self._num_samples:
+                self._start()
+                yield False
+
+        self._write_report()
+        yield True
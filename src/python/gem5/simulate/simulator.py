@@ -55,6 +55,7 @@ from .exit_event_generators import (
     switch_generator,
     warn_default_decorator,
 )
+from .sampling import SmartsSampler
 
 
 class Simulator:
@@ -346,6 +347,7 @@ class Simulator:
 
         self._last_exit_event = None
         self._exit_event_count = 0
+        self._sampler = None
 
         if checkpoint_path:
             warn(
@@ -387,6 +389,21 @@ class Simulator:
         for core in self._board.get_processor().get_cores():
             core._set_inst_stop_any_thread(inst, self._instantiated)
 
+    def schedule_sampling(self, sampler: SmartsSampler) -> None:
+        """
+        Run a sampled simulation, driven by the ``SCHEDULED_TICK`` exit
+        events of the given sampler. Any other handler of ``SCHEDULED_TICK``
+        is replaced, and ``run()`` returns once all samples are taken.
+
+        :param sampler: The sampler to run.
+        """
+        if self._on_exit_event is self._default_on_exit_dict:
+            self._on_exit_event = dict(self._default_on_exit_dict)
+        self._on_exit_event[ExitEvent.SCHEDULED_TICK] = sampler._run()
+        self._sampler = sampler
+        if self._instantiated:
+            sampler._start()
+
     def get_stats(self) -> Dict:
         """
         Obtain the current simulation statistics as a Dictionary, conforming
@@ -537,12 +554,32 @@ class Simulator:
             # scheduling of exits for the non-KVM cores will be incorrect. This
             # will be fixed at a later date.
             processor = self._board.processor
+            # Boards simulated with several event queues bound the quantum
+            # by the lookahead between the queues.
+            board_quantum = None
+            if hasattr(self._board, "get_sim_quantum"):
+                board_quantum = self._board.get_sim_quantum()
+
             if any(core.is_kvm_core() for core in processor.get_cores()) or (
                 isinstance(processor, SwitchableProcessor)
                 and any(core.is_kvm_core() for core in processor._all_cores())
             ):
                 m5.ticks.fixGlobalFrequency()
-                root.sim_quantum = m5.ticks.fromSeconds(0.001)
+                kvm_quantum = m5.ticks.fromSeconds(0.001)
+                root.sim_quantum = kvm_quantum
+                if board_quantum and isinstance(
+                    processor, SwitchableProcessor
+                ):
+                    # The KVM cores access memory atomically, which needs no
+                    # lookahead, so only the other cores use the board
+                    # quantum, which would slow KVM down to a crawl.
+                    processor._set_sim_quanta(kvm_quantum, board_quantum)
+                    if not any(
+                        core.is_kvm_core() for core in processor.get_cores()
+                    ):
+                        root.sim_quantum = board_quantum
+            elif board_quantum:
+                root.sim_quantum = board_quantum
 
             # m5.instantiate() takes a parameter specifying the path to the
             # checkpoint directory. If the parameter is None, no checkpoint
@@ -557,6 +594,9 @@ class Simulator:
             # any final things.
             self._board._post_instantiate()
 
+            if self._sampler:
+                self._sampler._start()
+
     def run(self, max_ticks: int = m5.MaxTick) -> None:
         """
         This function will start or continue the simulator run and handle exit
@@ -36,6 +36,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import atexit
 import code
 import datetime
 import os
@@ -227,12 +228,42 @@ def parse_options():
         default="stats.txt",
         help="Sets the output file for statistics [Default: %default]",
     )
+    option(
+        "--stats-filter",
+        metavar="GLOB[,GLOB]",
+        action="append",
+        split=",",
+        help="Only print the stats whose full names match one of the "
+        "GLOBs, and stop sampling the distributions among the others",
+    )
     option(
         "--stats-help",
         action="callback",
         callback=_stats_help,
         help="Display documentation for available stat visitors",
     )
+    option(
+        "--host-profile",
+        metavar="FILE",
+        default="",
+        help="Write the host time spent in each SimObject and event to "
+        "FILE at every stats dump",
+    )
+    option(
+        "--host-profile-period",
+        metavar="N",
+        type="int",
+        default=1,
+        help="Time one in every N events for the host profile "
+        "[Default: %default]",
+    )
+    option(
+        "--startup-profile",
+        metavar="FILE",
+        default="",
+        help="Write the host time spent in each phase of the startup, "
+        "from the config script to the first tick, to FILE",
+    )
 
     # Configuration Options
     group("Configuration Options")
@@ -301,6 +332,13 @@ def parse_options():
         help="Sets the output file for debug. Append '.gz' to the name for it"
         " to be compressed automatically [Default: %default]",
     )
+    option(
+        "--debug-binary-file",
+        metavar="FILE",
+        default="",
+        help="Sets the output file for the binary trace points (BTRACE), "
+        "which are printed with the debug output otherwise",
+    )
     option(
         "--debug-activate",
         metavar="EXPR[,EXPR]",
@@ -558,6 +596,12 @@ def main():
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    if options.stats_filter:
+        stats.setFilter(options.stats_filter)
+    if options.host_profile:
+        core.enableHostProfile(
+            options.host_profile_period, options.host_profile
+        )
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -611,6 +655,9 @@ def main():
         event.mainq.schedule(e, options.debug_end)
 
     trace.output(options.debug_file)
+    if options.debug_binary_file:
+        trace.binaryOutput(options.debug_binary_file)
+        atexit.register(trace.binaryFlush)
 
     for activate in options.debug_activate:
         _check_tracing()
@@ -644,6 +691,8 @@ def main():
             filecode = compile(filedata, filename, "exec")
             scope = {"__file__": filename, "__name__": "__m5_main__"}
 
+        m5.markStartupBegin()
+
         # if pdb was requested, execfile the thing under pdb, otherwise,
         # just do the execfile normally
         if options.pdb:
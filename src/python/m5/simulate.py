@@ -38,8 +38,11 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 import atexit
+import json
 import os
 import sys
+import time
+from contextlib import contextmanager
 
 from m5.util.dot_writer import (
     do_dot,
@@ -74,6 +77,44 @@ _drain_manager = _m5.drain.DrainManager.instance()
 
 _instantiated = False  # Has m5.instantiate() been called?
 
+# Host seconds spent in each phase of the startup, from the start of the
+# config script to the first tick, in the order of the phases
+startup_phases = {}
+
+# Host time at which the config script started, if known
+startup_begin = None
+
+
+def markStartupBegin():
+    """Mark the start of the config script, the first startup phase."""
+    global startup_begin
+    startup_begin = time.perf_counter()
+
+
+@contextmanager
+def _startup_phase(name):
+    start = time.perf_counter()
+    yield
+    startup_phases[name] = (
+        startup_phases.get(name, 0.0) + time.perf_counter() - start
+    )
+
+
+def _write_startup_profile(num_objects):
+    from m5 import options
+
+    if not getattr(options, "startup_profile", ""):
+        return
+
+    profile = {
+        "objects": num_objects,
+        "total_seconds": sum(startup_phases.values()),
+        "phases": startup_phases,
+    }
+    path = os.path.join(options.outdir, options.startup_profile)
+    with open(path, "w") as profile_file:
+        json.dump(profile, profile_file, indent=4)
+
 
 # The final call to instantiate the SimObject graph and initialize the
 # system.
@@ -91,66 +132,74 @@ def instantiate(ckpt_dir=None):
     if not root:
         fatal("Need to instantiate Root() before calling instantiate()")
 
+    if startup_begin is not None:
+        startup_phases["configure"] = time.perf_counter() - startup_begin
+
     # we need to fix the global frequency
     ticks.fixGlobalFrequency()
 
     # Make sure SimObject-valued params are in the configuration
     # hierarchy so we catch them with future descendants() walks
-    for obj in root.descendants():
-        obj.adoptOrphanParams()
+    with _startup_phase("adopt"):
+        for obj in root.descendants():
+            obj.adoptOrphanParams()
 
     # Unproxy in sorted order for determinism
-    for obj in root.descendants():
-        obj.unproxyParams()
-
-    if options.dump_config:
-        ini_file = open(os.path.join(options.outdir, options.dump_config), "w")
-        # Print ini sections in sorted order for easier diffing
-        for obj in sorted(root.descendants(), key=lambda o: o.path()):
-            obj.print_ini(ini_file)
-        ini_file.close()
+    with _startup_phase("unproxy"):
+        for obj in root.descendants():
+            obj.unproxyParams()
 
-    if options.json_config:
-        try:
-            import json
+    with _startup_phase("dump_config"):
+        if options.dump_config:
+            ini_file = open(
+                os.path.join(options.outdir, options.dump_config), "w"
+            )
+            # Print ini sections in sorted order for easier diffing
+            for obj in sorted(root.descendants(), key=lambda o: o.path()):
+                obj.print_ini(ini_file)
+            ini_file.close()
 
+        if options.json_config:
             json_file = open(
                 os.path.join(options.outdir, options.json_config), "w"
             )
             d = root.get_config_as_dict()
             json.dump(d, json_file, indent=4)
             json_file.close()
-        except ImportError:
-            pass
 
-    if options.dot_config:
-        do_dot(root, options.outdir, options.dot_config)
-        do_ruby_dot(root, options.outdir, options.dot_config)
+        if options.dot_config:
+            do_dot(root, options.outdir, options.dot_config)
+            do_ruby_dot(root, options.outdir, options.dot_config)
 
     # Initialize the global statistics
     stats.initSimStats()
 
     # Create the C++ sim objects and connect ports
-    for obj in root.descendants():
-        obj.createCCObject()
-    for obj in root.descendants():
-        obj.connectPorts()
+    with _startup_phase("create"):
+        for obj in root.descendants():
+            obj.createCCObject()
+    with _startup_phase("connect"):
+        for obj in root.descendants():
+            obj.connectPorts()
 
     # Do a second pass to finish initializing the sim objects
-    for obj in root.descendants():
-        obj.init()
+    with _startup_phase("init"):
+        for obj in root.descendants():
+            obj.init()
 
     # Do a third pass to initialize statistics
-    stats._bindStatHierarchy(root)
-    root.regStats()
+    with _startup_phase("stats"):
+        stats._bindStatHierarchy(root)
+        root.regStats()
 
     # Do a fourth pass to initialize probe points
-    for obj in root.descendants():
-        obj.regProbePoints()
+    with _startup_phase("probes"):
+        for obj in root.descendants():
+            obj.regProbePoints()
 
-    # Do a fifth pass to connect probe listeners
-    for obj in root.descendants():
-        obj.regProbeListeners()
+        # Do a fifth pass to connect probe listeners
+        for obj in root.descendants():
+            obj.regProbeListeners()
 
     # We want to generate the DVFS diagram for the system. This can only be
     # done once all of the CPP objects have been created and initialised so
@@ -159,17 +208,19 @@ def instantiate(ckpt_dir=None):
         do_dvfs_dot(root, options.outdir, options.dot_dvfs_config)
 
     # We're done registering statistics.  Enable the stats package now.
-    stats.enable()
+    with _startup_phase("stats"):
+        stats.enable()
 
     # Restore checkpoint (if any)
-    if ckpt_dir:
-        _drain_manager.preCheckpointRestore()
-        ckpt = _m5.core.getCheckpoint(ckpt_dir)
-        for obj in root.descendants():
-            obj.loadState(ckpt)
-    else:
-        for obj in root.descendants():
-            obj.initState()
+    with _startup_phase("init_state"):
+        if ckpt_dir:
+            _drain_manager.preCheckpointRestore()
+            ckpt = _m5.core.getCheckpoint(ckpt_dir)
+            for obj in root.descendants():
+                obj.loadState(ckpt)
+        else:
+            for obj in root.descendants():
+                obj.initState()
 
     # Check to see if any of the stat events are in the past after resuming from
     # a checkpoint, If so, this call will shift them to be at a valid time.
@@ -190,9 +241,12 @@ def simulate(*args, **kwargs):
 
     if need_startup:
         root = objects.Root.getInstance()
-        for obj in root.descendants():
-            obj.startup()
+        all_objects = list(root.descendants())
+        with _startup_phase("startup"):
+            for obj in all_objects:
+                obj.startup()
         need_startup = False
+        _write_startup_profile(len(all_objects))
 
         # Python exit handlers happen in reverse order.
         # We want to dump stats last.
@@ -235,6 +289,22 @@ def getMaxTick() -> int:
     return _m5.event.getMaxTick()
 
 
+def setSimQuantum(quantum: int) -> None:
+    """Sets the simulation quantum, the period at which the event queues
+    are synchronised, from the next run of the simulation loop. This lets
+    the quantum follow the cores, e.g. a long quantum for KVM cores and a
+    short one for the cores timing the memory system.
+
+    :param quantum: the quantum in ticks.
+    """
+    _m5.event.setSimQuantum(quantum=quantum)
+
+
+def getSimQuantum() -> int:
+    """Returns the current simulation quantum in ticks."""
+    return _m5.event.getSimQuantum()
+
+
 def getTicksUntilMax() -> int:
     """Returns the current number of ticks until the maximum tick."""
     return getMaxTick() - curTick()
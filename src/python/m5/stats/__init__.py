@@ -45,7 +45,9 @@ from m5.util import (
     fatal,
 )
 
+import _m5.core
 import _m5.stats
+import _m5.trace
 
 # Stat exports
 from _m5.stats import periodicStatDump
@@ -190,6 +192,28 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
 
+@_url_factory(["columnar"])
+def _columnarFactory(fn):
+    """Output stats as a columnar time series.
+
+    Columnar stat files hold one fixed width binary row per stat dump,
+    and only write the names of the stats once. This makes frequent
+    periodic dumps cheap to write and small to store. The file is gzip
+    compressed if its name ends in .gz. Use util/read_columnar_stats.py
+    to read it.
+
+    Known limitations:
+      * Every dump must cover the same stats as the first.
+      * Sparse histograms are left out.
+
+    Example:
+      columnar://stats.col.gz
+
+    """
+
+    return _m5.stats.initColumnar(fn)
+
+
 @_url_factory(["json"])
 def _jsonFactory(fn):
     """Output stats in JSON format.
@@ -307,6 +331,43 @@ names = []
 stats_dict = {}
 stats_list = []
 
+# Glob patterns of the stats to keep, all stats if empty.
+stats_filter = []
+
+
+def setFilter(patterns):
+    """Only keep the stats whose full names match one of the given glob
+    patterns, e.g. "board.cache_hierarchy.*.overallMisses*".
+
+    The other stats are not printed, and the distributions and
+    histograms among them stop adding samples. This must be done before
+    the statistics package is enabled."""
+
+    global stats_filter
+    stats_filter = list(patterns)
+
+
+def _apply_filter():
+    from fnmatch import fnmatchcase
+
+    def keep(name):
+        return any(fnmatchcase(name, p) for p in stats_filter)
+
+    def filter_group(group, path):
+        for stat in group.getStats():
+            if not keep(f"{path}{stat.name}"):
+                stat.disable()
+        for name, child in group.getStatGroups().items():
+            filter_group(child, f"{path}{name}.")
+
+    for stat in stats_list:
+        if not keep(stat.name):
+            stat.disable()
+
+    root = Root.getInstance()
+    if root:
+        filter_group(root, "")
+
 
 def enable():
     """Enable the statistics package.  Before the statistics package is
@@ -341,6 +402,9 @@ def enable():
     _visit_stats(check_stat)
     _visit_stats(lambda g, s: s.enable())
 
+    if stats_filter:
+        _apply_filter()
+
     _m5.stats.enable()
 
 
@@ -429,6 +493,11 @@ def dump(roots=None):
                 _dump_to_visitor(output, roots=all_roots)
                 output.end()
 
+    if new_dump:
+        _m5.core.dumpHostProfile()
+        # the binary trace up to the dump is complete on disk
+        _m5.trace.binaryFlush()
+
 
 def reset():
     """Reset all statistics to the base state"""
@@ -444,6 +513,8 @@ def reset():
 
     _m5.stats.processResetQueue()
 
+    _m5.core.resetHostProfile()
+
 
 flags = attrdict(
     {
@@ -27,6 +27,8 @@
 # Export native methods to Python
 from _m5.trace import (
     activate,
+    binaryFlush,
+    binaryOutput,
     disable,
     enable,
     ignore,
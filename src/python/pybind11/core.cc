@@ -56,6 +56,7 @@
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/drain.hh"
+#include "sim/host_profile.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_object.hh"
 #include "cpu/probes/pc_count_pair.hh"
@@ -319,6 +320,10 @@ pybind_init_core(py::module_ &m_native)
         .def("setClockFrequency", &setClockFrequency)
         .def("getClockFrequency", &getClockFrequency)
         .def("curTick", curTick)
+
+        .def("enableHostProfile", &host_profile::enable)
+        .def("dumpHostProfile", []() { host_profile::dump(); })
+        .def("resetHostProfile", &host_profile::reset)
         ;
 
     /* TODO: These should be read-only */
@@ -45,6 +45,7 @@
 #include <map>
 #include <vector>
 
+#include "base/binary_trace.hh"
 #include "base/compiler.hh"
 #include "base/debug.hh"
 #include "base/output.hh"
@@ -67,6 +68,12 @@ output(const char *filename)
     trace::setDebugLogger(new trace::OstreamLogger(*file_stream->stream()));
 }
 
+static void
+binaryOutput(const char *filename)
+{
+    binary_trace::setOutput(simout.resolve(filename));
+}
+
 static void
 activate(const char *expr)
 {
@@ -129,6 +136,8 @@ pybind_init_debug(py::module_ &m_native)
     py::module_ m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("binaryOutput", &binaryOutput)
+        .def("binaryFlush", &binary_trace::flush)
         .def("activate", &activate)
         .def("ignore", &ignore)
         .def("enable", &trace::enable)
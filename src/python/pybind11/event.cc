@@ -109,6 +109,9 @@ pybind_init_event(py::module_ &m_native)
           py::arg("ticks") = MaxTick);
     m.def("setMaxTick", &set_max_tick, py::arg("tick"));
     m.def("getMaxTick", &get_max_tick, py::return_value_policy::copy);
+    m.def("setSimQuantum", [](Tick quantum) { simQuantum = quantum; },
+          py::arg("quantum"));
+    m.def("getSimQuantum", []() { return simQuantum; });
     m.def("terminateEventQueueThreads", &terminateEventQueueThreads);
     m.def("exitSimLoop", &exitSimLoop);
     m.def("getEventQueue", []() { return curEventQueue(); },
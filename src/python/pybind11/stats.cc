@@ -42,6 +42,7 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/columnar.hh"
 #include "base/stats/text.hh"
 #include "config/have_hdf5.hh"
 
@@ -114,6 +115,7 @@ pybind_init_stats(py::module_ &m_native)
 #if HAVE_HDF5
         .def("initHDF5", &statistics::initHDF5)
 #endif
+        .def("initColumnar", &statistics::initColumnar)
         .def("registerPythonStatsHandlers",
              &statistics::registerPythonStatsHandlers)
         .def("schedStatEvent", &statistics::schedStatEvent)
@@ -148,6 +150,7 @@ pybind_init_stats(py::module_ &m_native)
         .def("check", &statistics::Info::check)
         .def("baseCheck", &statistics::Info::baseCheck)
         .def("enable", &statistics::Info::enable)
+        .def("disable", &statistics::Info::disable)
         .def("prepare", &statistics::Info::prepare)
         .def("reset", &statistics::Info::reset)
         .def("zero", &statistics::Info::zero)
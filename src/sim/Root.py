@@ -67,6 +67,12 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Index the event queues with a calendar, which keeps scheduling
+    # close to constant time with many pending events (e.g., many cores).
+    calendar_event_queue = Param.Bool(
+        False, "use a calendar index in the event queues"
+    )
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
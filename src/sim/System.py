@@ -104,6 +104,18 @@ class System(SimObject):
         "shared_backstore is non-empty.",
     )
 
+    memory_checkpoint_threads = Param.Unsigned(
+        0,
+        "Host threads that compress memory into checkpoints and restore "
+        "it from them, 0 for one per host core",
+    )
+    lazy_memory_restore = Param.Bool(
+        False,
+        "Restore memory from a checkpoint a chunk at a time, when it is "
+        "first touched, instead of all at once. Chunks that are never "
+        "touched take no host memory.",
+    )
+
     cache_line_size = Param.Unsigned(64, "Cache line size in bytes")
 
     redirect_paths = VectorParam.RedirectPath([], "Path redirections")
@@ -30,17 +30,21 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
+#include "sim/host_profile.hh"
 
 namespace gem5
 {
@@ -57,6 +61,21 @@ uint32_t numMainEventQueues = 0;
 std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+bool calendarEventQueues = false;
+
+namespace
+{
+
+//! Number of slots of the calendar index of an event queue.
+const size_t calendarSize = 4096;
+
+//! Initial log2 of the width of a calendar slice in ticks.
+const unsigned calendarInitShift = 10;
+
+//! Number of list searches between two adaptations of the width.
+const uint64_t calendarAdaptPeriod = 8192;
+
+} // anonymous namespace
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -134,27 +153,156 @@ Event::releaseImpl()
         delete this;
 }
 
+Event *
+EventQueue::findPrevBin(const Event *event)
+{
+    Event *prev = head;
+
+    if (!calendar.empty()) {
+        // start from the last bin of the closest indexed slice that is
+        // ordered before the event, there is none before the head
+        const Tick slice = event->when() >> calendarShift;
+        const Tick scan = std::min<Tick>(
+            slice - (head->when() >> calendarShift), calendar.size() - 1);
+        for (Tick i = 0; i <= scan; i++) {
+            const CalendarSlot &slot =
+                calendar[(slice - i) & (calendar.size() - 1)];
+            if (slot.last && slot.slice == slice - i &&
+                *slot.last < *event) {
+                prev = slot.last;
+                break;
+            }
+            calendarScanSteps++;
+        }
+        calendarOps++;
+    }
+
+    uint64_t steps = 0;
+    Event *curr = prev->nextBin;
+    while (curr && *curr < *event) {
+        prev = curr;
+        curr = curr->nextBin;
+        steps++;
+    }
+    calendarWalkSteps += steps;
+
+    return prev;
+}
+
 void
 EventQueue::insert(Event *event)
 {
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
+    } else {
+        // Figure out either which 'in bin' list we are on, or where a
+        // new list needs to be inserted
+        Event *prev = findPrevBin(event);
+
+        // Note: this operation may render all nextBin pointers on the
+        // prev 'in bin' list stale (except for the top one)
+        prev->nextBin = Event::insertBefore(event, prev->nextBin);
+    }
+
+    if (!calendar.empty()) {
+        calendarInserted(event);
+        if (calendarOps >= calendarAdaptPeriod)
+            calendarAdapt();
+    }
+}
+
+void
+EventQueue::calendarInserted(Event *event)
+{
+    const Tick slice = event->when() >> calendarShift;
+    CalendarSlot &slot = calendar[slice & (calendar.size() - 1)];
+
+    if (event->nextInBin) {
+        // the event was pushed on top of an existing bin
+        if (slot.last == event->nextInBin)
+            slot.last = event;
+    } else if (!slot.last) {
+        // claim the slot, the new bin is not necessarily the last one
+        // of its slice
+        slot.slice = slice;
+        slot.last = event;
+        for (Event *next = event->nextBin;
+             next && (next->when() >> calendarShift) == slice;
+             next = next->nextBin) {
+            slot.last = next;
+        }
+    } else if (slot.slice == slice && *slot.last < *event) {
+        slot.last = event;
+    }
+}
+
+void
+EventQueue::calendarRemoved(Event *top, Event *prev)
+{
+    const Tick slice = top->when() >> calendarShift;
+    CalendarSlot &slot = calendar[slice & (calendar.size() - 1)];
+
+    if (slot.last != top)
         return;
+
+    if (top->nextInBin)
+        slot.last = top->nextInBin;
+    else if (prev && (prev->when() >> calendarShift) == slice)
+        slot.last = prev;
+    else
+        slot.last = nullptr;
+}
+
+void
+EventQueue::calendarRebuild()
+{
+    std::fill(calendar.begin(), calendar.end(), CalendarSlot());
+
+    // the bins come in time order, so the first slice to claim a slot
+    // keeps it, and its last bin is the last one seen
+    for (Event *bin = head; bin; bin = bin->nextBin) {
+        const Tick slice = bin->when() >> calendarShift;
+        CalendarSlot &slot = calendar[slice & (calendar.size() - 1)];
+        if (!slot.last || slot.slice == slice) {
+            slot.slice = slice;
+            slot.last = bin;
+        }
     }
+}
 
-    // Figure out either which 'in bin' list we are on, or where a new list
-    // needs to be inserted
-    Event *prev = head;
-    Event *curr = head->nextBin;
-    while (curr && *curr < *event) {
-        prev = curr;
-        curr = curr->nextBin;
+void
+EventQueue::calendarAdapt()
+{
+    // slices that are too wide hold many bins to walk through, while
+    // slices that are too narrow leave many empty slots to scan. Events
+    // past the reach of the calendar scan all the slots and then walk
+    // from the head, so a long scan is looked at first.
+    const unsigned old_shift = calendarShift;
+    if (calendarScanSteps > 4 * calendarOps && calendarShift < 40)
+        calendarShift++;
+    else if (calendarWalkSteps > 4 * calendarOps && calendarShift > 0)
+        calendarShift--;
+
+    calendarOps = calendarWalkSteps = calendarScanSteps = 0;
+
+    if (calendarShift != old_shift)
+        calendarRebuild();
+}
+
+void
+EventQueue::enableCalendar(bool enable)
+{
+    if (!enable) {
+        calendar.clear();
+        calendar.shrink_to_fit();
+        return;
     }
 
-    // Note: this operation may render all nextBin pointers on the
-    // prev 'in bin' list stale (except for the top one)
-    prev->nextBin = Event::insertBefore(event, curr);
+    if (calendar.empty()) {
+        calendar.resize(calendarSize);
+        calendarRebuild();
+    }
 }
 
 Event *
@@ -199,17 +347,16 @@ EventQueue::remove(Event *event)
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
+        Event *top = head;
         head = Event::removeItem(event, head);
+        if (!calendar.empty() && event == top)
+            calendarRemoved(top, nullptr);
         return;
     }
 
     // Find the 'in bin' list that this event belongs on
-    Event *prev = head;
-    Event *curr = head->nextBin;
-    while (curr && *curr < *event) {
-        prev = curr;
-        curr = curr->nextBin;
-    }
+    Event *prev = findPrevBin(event);
+    Event *curr = prev->nextBin;
 
     if (!curr || *curr != *event)
         panic("event not found!");
@@ -218,8 +365,34 @@ EventQueue::remove(Event *event)
     // we remove an item, it returns the new top item (which may be
     // unchanged)
     prev->nextBin = Event::removeItem(event, curr);
+    if (!calendar.empty() && event == curr)
+        calendarRemoved(curr, prev);
 }
 
+namespace
+{
+
+/** Process an event, timing it if it is due for a profile sample. */
+void
+processProfiled(Event *event)
+{
+    thread_local unsigned countdown = 0;
+    if (countdown) {
+        --countdown;
+        event->process();
+        return;
+    }
+    countdown = host_profile::samplePeriod - 1;
+
+    auto start = std::chrono::steady_clock::now();
+    event->process();
+    auto nsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    host_profile::record(event, nsecs);
+}
+
+} // anonymous namespace
+
 Event *
 EventQueue::serviceOne()
 {
@@ -228,6 +401,9 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
+    if (!calendar.empty())
+        calendarRemoved(event, nullptr);
+
     if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
@@ -244,9 +420,13 @@ EventQueue::serviceOne()
     if (!event->squashed()) {
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
+        ++_numServiced;
         if (debug::Event)
             event->trace("executed");
-        event->process();
+        if (GEM5_UNLIKELY(host_profile::samplePeriod))
+            processProfiled(event);
+        else
+            event->process();
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -375,6 +555,24 @@ EventQueue::debugVerify() const
         nextBin = nextBin->nextBin;
     }
 
+    // every indexed slot must hold the last bin of its slice
+    for (const auto &slot : calendar) {
+        if (!slot.last)
+            continue;
+
+        Event *bin = head;
+        while (bin && bin != slot.last)
+            bin = bin->nextBin;
+
+        if (!bin || (bin->when() >> calendarShift) != slot.slice ||
+            (bin->nextBin &&
+             (bin->nextBin->when() >> calendarShift) == slot.slice)) {
+            cprintf("calendar slot out of date!");
+            slot.last->dump();
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -383,6 +581,8 @@ EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
     head = s;
+    if (!calendar.empty())
+        calendarRebuild();
     return t;
 }
 
@@ -442,8 +642,11 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), calendarShift(calendarInitShift),
+      calendarOps(0), calendarWalkSteps(0), calendarScanSteps(0)
 {
+    if (calendarEventQueues)
+        enableCalendar(true);
 }
 
 void
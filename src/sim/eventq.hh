@@ -43,6 +43,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/debug.hh"
 #include "base/flags.hh"
@@ -82,6 +83,9 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Whether the main event queues are indexed with a calendar.
+extern bool calendarEventQueues;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
@@ -621,6 +625,56 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    /** Number of events processed by this queue. */
+    uint64_t _numServiced = 0;
+
+    /**
+     * A slot of the calendar index, holding the last bin of the time
+     * slice that currently owns the slot.
+     */
+    struct CalendarSlot
+    {
+        Tick slice = 0;
+        Event *last = nullptr;
+    };
+
+    /**
+     * Optional calendar index over the bins of the queue. Time is cut
+     * into slices of 2^calendarShift ticks, and slice s owns slot
+     * s % calendar.size() as long as no other slice holds it. Inserting
+     * or removing an event then only walks the bins of its own slice,
+     * starting from the last bin of the closest indexed slice before
+     * it, instead of all the bins from the head of the queue. The bin
+     * list stays the reference, so the ordering is exactly that of the
+     * plain list. The index is empty when disabled.
+     */
+    std::vector<CalendarSlot> calendar;
+
+    //! Log2 of the width of a calendar slice in ticks.
+    unsigned calendarShift;
+
+    //! Operations and list steps since the width was last adapted.
+    uint64_t calendarOps;
+    uint64_t calendarWalkSteps;
+    uint64_t calendarScanSteps;
+
+    //! Find the last bin ordered before an event, which must not be
+    //! ordered before the head of the queue.
+    Event *findPrevBin(const Event *event);
+
+    //! Update the calendar after event was made the top of its bin.
+    void calendarInserted(Event *event);
+
+    //! Update the calendar after the bin topped by top lost its top
+    //! item, prev being the bin before it (or nullptr).
+    void calendarRemoved(Event *top, Event *prev);
+
+    //! Index all bins of the queue from scratch.
+    void calendarRebuild();
+
+    //! Resize the calendar slices based on the recent list walks.
+    void calendarAdapt();
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
@@ -850,6 +904,9 @@ class EventQueue
     Tick getCurTick() const { return _curTick; }
     Event *getHead() const { return head; }
 
+    /** Number of events this queue has processed so far. */
+    uint64_t numServiced() const { return _numServiced; }
+
     Event *serviceOne();
 
     /**
@@ -932,6 +989,16 @@ class EventQueue
      */
     Event* replaceHead(Event* s);
 
+    /**
+     * Index the queue with a calendar, which makes scheduling close to
+     * constant time with many pending events, or go back to the plain
+     * sorted bin list.
+     */
+    void enableCalendar(bool enable);
+
+    /** Log2 of the width of the calendar slices in ticks. */
+    unsigned getCalendarShift() const { return calendarShift; }
+
     /**@{*/
     /**
      * Provide an interface for locking/unlocking the event queue.
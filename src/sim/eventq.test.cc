@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** An event that logs its id when it is processed. */
+class LogEvent : public Event
+{
+  public:
+    LogEvent(int _id, std::vector<int> &_log, Priority p)
+        : Event(p), id(_id), log(_log)
+    {}
+
+    void process() override { log.push_back(id); }
+
+  private:
+    const int id;
+    std::vector<int> &log;
+};
+
+/**
+ * Schedule, reschedule and deschedule the same pseudo random set of
+ * events on a queue and return the order in which they are processed.
+ */
+std::vector<int>
+runMix(bool calendar, unsigned num_events, Tick spread)
+{
+    EventQueue eq("test_eq");
+    eq.enableCalendar(calendar);
+
+    std::vector<int> log;
+    std::vector<std::unique_ptr<LogEvent>> events;
+    std::mt19937_64 rng(42);
+    const Event::Priority prios[] = {
+        Event::Minimum_Pri, Event::Default_Pri, Event::CPU_Tick_Pri,
+        Event::Maximum_Pri };
+
+    for (unsigned i = 0; i < num_events; i++) {
+        events.emplace_back(new LogEvent(i, log, prios[rng() % 4]));
+        eq.schedule(events.back().get(), 1 + rng() % spread);
+    }
+    EXPECT_TRUE(eq.debugVerify());
+
+    for (unsigned i = 0; i < num_events; i += 3)
+        eq.reschedule(events[i].get(), 1 + rng() % spread);
+    for (unsigned i = 1; i < num_events; i += 7)
+        eq.deschedule(events[i].get());
+    EXPECT_TRUE(eq.debugVerify());
+
+    while (!eq.empty()) {
+        eq.serviceOne();
+
+        // keep adding events while the queue drains
+        if (log.size() % 5 == 0 && !events[log.back()]->scheduled())
+            eq.schedule(events[log.back()].get(),
+                        eq.getCurTick() + rng() % spread);
+    }
+    EXPECT_TRUE(eq.debugVerify());
+
+    return log;
+}
+
+/**
+ * Run the hold model, where each processed event is scheduled again a
+ * random delay later, on a list queue and a calendar queue side by
+ * side, and check that both process the same event at every step.
+ *
+ * @return The calendar shifts the calendar queue went through.
+ */
+std::vector<unsigned>
+runHoldPair(EventQueue &list_eq, EventQueue &cal_eq,
+            std::vector<std::unique_ptr<LogEvent>> &list_events,
+            std::vector<std::unique_ptr<LogEvent>> &cal_events,
+            std::vector<int> &list_log, std::vector<int> &cal_log,
+            std::mt19937_64 &rng, unsigned num_processed, Tick spread)
+{
+    std::vector<unsigned> shifts = {cal_eq.getCalendarShift()};
+
+    for (unsigned i = 0; i < num_processed; i++) {
+        list_eq.serviceOne();
+        cal_eq.serviceOne();
+        EXPECT_EQ(list_log.back(), cal_log.back());
+        if (list_log.back() != cal_log.back())
+            break;
+
+        const Tick when = list_eq.getCurTick() + 1 + rng() % spread;
+        list_eq.schedule(list_events[list_log.back()].get(), when);
+        cal_eq.schedule(cal_events[cal_log.back()].get(), when);
+
+        // the calendar was rebuilt with slices of another width
+        if (cal_eq.getCalendarShift() != shifts.back()) {
+            shifts.push_back(cal_eq.getCalendarShift());
+            EXPECT_TRUE(cal_eq.debugVerify());
+        }
+    }
+
+    return shifts;
+}
+
+} // anonymous namespace
+
+/** The calendar must process events in exactly the order of the list. */
+TEST(EventQueueTest, CalendarKeepsOrder)
+{
+    EXPECT_EQ(runMix(false, 2000, 1000), runMix(true, 2000, 1000));
+}
+
+/** Same with events spread far enough to share calendar slots. */
+TEST(EventQueueTest, CalendarKeepsOrderSparse)
+{
+    EXPECT_EQ(runMix(false, 2000, 1ULL << 36), runMix(true, 2000, 1ULL << 36));
+}
+
+/** Same with all the events in a few bins. */
+TEST(EventQueueTest, CalendarKeepsOrderDense)
+{
+    EXPECT_EQ(runMix(false, 2000, 4), runMix(true, 2000, 4));
+}
+
+/** Switching the calendar on and off with pending events. */
+TEST(EventQueueTest, CalendarToggle)
+{
+    EventQueue eq("test_eq");
+    std::vector<int> log;
+    LogEvent e0(0, log, Event::Default_Pri), e1(1, log, Event::Default_Pri),
+             e2(2, log, Event::Default_Pri);
+
+    eq.schedule(&e2, 300);
+    eq.schedule(&e0, 100);
+    eq.enableCalendar(true);
+    eq.schedule(&e1, 200);
+    EXPECT_TRUE(eq.debugVerify());
+    eq.enableCalendar(false);
+
+    while (!eq.empty())
+        eq.serviceOne();
+    EXPECT_EQ(log, std::vector<int>({0, 1, 2}));
+}
+
+/**
+ * The calendar adapts the width of its slices to the spread of the
+ * pending events, narrowing them while the events are clustered and
+ * widening them once they are sparse, and keeps the order of the list
+ * across every rebuild.
+ */
+TEST(EventQueueTest, CalendarAdaptKeepsOrder)
+{
+    const unsigned pending = 1000;
+    // many adapt periods of 8192 calendar operations per phase
+    const unsigned num_processed = 200000;
+
+    EventQueue list_eq("list_eq"), cal_eq("cal_eq");
+    cal_eq.enableCalendar(true);
+
+    std::vector<int> list_log, cal_log;
+    std::vector<std::unique_ptr<LogEvent>> list_events, cal_events;
+    std::mt19937_64 rng(7);
+    for (unsigned i = 0; i < pending; i++) {
+        const Event::Priority prio =
+            rng() % 2 ? Event::Default_Pri : Event::CPU_Tick_Pri;
+        list_events.emplace_back(new LogEvent(i, list_log, prio));
+        cal_events.emplace_back(new LogEvent(i, cal_log, prio));
+        const Tick when = 1 + rng() % 256;
+        list_eq.schedule(list_events.back().get(), when);
+        cal_eq.schedule(cal_events.back().get(), when);
+    }
+
+    // clustered: many bins per slice, so the slices get narrower
+    std::vector<unsigned> shifts = runHoldPair(
+        list_eq, cal_eq, list_events, cal_events, list_log, cal_log, rng,
+        num_processed, 256);
+    ASSERT_GT(shifts.size(), 1);
+    EXPECT_LT(shifts.back(), shifts.front());
+
+    // sparse: many empty slots to scan, so the slices get wider
+    shifts = runHoldPair(
+        list_eq, cal_eq, list_events, cal_events, list_log, cal_log, rng,
+        num_processed, 1ULL << 32);
+    ASSERT_GT(shifts.size(), 1);
+    EXPECT_GT(shifts.back(), shifts.front());
+
+    EXPECT_EQ(list_log, cal_log);
+    EXPECT_TRUE(list_eq.debugVerify());
+    EXPECT_TRUE(cal_eq.debugVerify());
+
+    for (auto *eq : {&list_eq, &cal_eq}) {
+        while (!eq->empty())
+            eq->deschedule(eq->getHead());
+    }
+}
+
+/**
+ * Events per second of the classic hold model, where each processed
+ * event schedules a new one a random delay later, with many events
+ * pending. This is a benchmark rather than a test; run it with
+ * --gtest_also_run_disabled_tests.
+ */
+TEST(EventQueueTest, DISABLED_HoldModelThroughput)
+{
+    const unsigned num_processed = 100000;
+
+    for (unsigned pending : {100, 1000, 10000}) {
+        for (bool calendar : {false, true}) {
+            EventQueue eq("bench_eq");
+            eq.enableCalendar(calendar);
+
+            std::mt19937_64 rng(1);
+            std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+            for (unsigned i = 0; i < pending; i++) {
+                EventFunctionWrapper *event = new EventFunctionWrapper(
+                    [] {}, "bench", false, Event::Default_Pri);
+                events.emplace_back(event);
+                eq.schedule(event, rng() % (pending * 500));
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned i = 0; i < num_processed; i++) {
+                Event *event = eq.getHead();
+                eq.serviceOne();
+                eq.schedule(event, eq.getCurTick() + rng() % (pending * 500));
+            }
+            std::chrono::duration<double> secs =
+                std::chrono::steady_clock::now() - start;
+
+            std::cout << (calendar ? "calendar" : "list    ")
+                      << " pending " << pending << ": "
+                      << num_processed / secs.count() << " events/s\n";
+
+            while (!eq.empty())
+                eq.deschedule(eq.getHead());
+        }
+    }
+}
@@ -0,0 +1,213 @@
+#include "sim/host_profile.hh"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "base/output.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+namespace host_profile
+{
+
+unsigned samplePeriod = 0;
+
+namespace
+{
+
+struct Entry
+{
+    uint64_t nsecs = 0;
+    uint64_t samples = 0;
+};
+
+typedef std::unordered_map<std::string, Entry> Table;
+
+/**
+ * Samples of one host thread. Only that thread records into it, but
+ * dump() and reset() may read and clear it from another thread.
+ */
+struct ThreadProfile
+{
+    std::mutex lock;
+    Table events;
+    /**
+     * Entries of the events sampled so far, so their names are only
+     * built once. The description tells when an event was destroyed and
+     * another one took its place.
+     */
+    std::unordered_map<const Event *, std::pair<const char *, Entry *>>
+        byEvent;
+};
+
+std::mutex profilesLock;
+
+/** Profiles of all threads, kept until the end of the simulation. */
+std::vector<ThreadProfile *> profiles;
+
+OutputStream *output = nullptr;
+
+ThreadProfile &
+threadProfile()
+{
+    thread_local ThreadProfile *profile = nullptr;
+    if (!profile) {
+        std::lock_guard<std::mutex> guard(profilesLock);
+        profile = new ThreadProfile;
+        profiles.push_back(profile);
+    }
+    return *profile;
+}
+
+std::string
+ownerOf(const std::string &event)
+{
+    size_t pos = event.rfind('.');
+    return pos == std::string::npos ? "(none)" : event.substr(0, pos);
+}
+
+void
+printTable(std::ostream &os, const char *title, const Table &table,
+           uint64_t total_nsecs)
+{
+    std::vector<std::pair<std::string, Entry>> rows(table.begin(),
+                                                    table.end());
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) {
+        return a.second.nsecs > b.second.nsecs;
+    });
+
+    ccprintf(os, "\n%-60s %14s %7s %12s %10s\n", title, "host_ns",
+             "%", "events", "ns/event");
+    for (const auto &row : rows) {
+        const Entry &entry = row.second;
+        ccprintf(os, "%-60s %14d %6.2f%% %12d %10.1f\n", row.first,
+                 entry.nsecs * samplePeriod,
+                 total_nsecs ? 100.0 * entry.nsecs / total_nsecs : 0.0,
+                 entry.samples * samplePeriod,
+                 double(entry.nsecs) / entry.samples);
+    }
+}
+
+} // anonymous namespace
+
+void
+enable(unsigned period, const std::string &path)
+{
+    samplePeriod = period;
+    if (period && !output)
+        output = simout.create(path);
+}
+
+std::string
+keyOf(const std::string &name, const char *description)
+{
+    static const std::string wrapped = ".wrapped_function_event";
+
+    if (name.compare(0, 6, "Event_") == 0) {
+        // default event names carry an instance number, so group those
+        // events by what they are instead
+        return description;
+    } else if (name.size() > wrapped.size() &&
+               name.compare(name.size() - wrapped.size(), wrapped.size(),
+                            wrapped) == 0) {
+        return name.substr(0, name.size() - wrapped.size());
+    } else {
+        return name;
+    }
+}
+
+void
+record(const std::string &name, const char *description, uint64_t nsecs)
+{
+    ThreadProfile &profile = threadProfile();
+    std::lock_guard<std::mutex> guard(profile.lock);
+
+    Entry &entry = profile.events[keyOf(name, description)];
+    entry.nsecs += nsecs;
+    ++entry.samples;
+}
+
+void
+record(const Event *event, uint64_t nsecs)
+{
+    // managed events come and go, so their addresses say little
+    if (event->isManaged()) {
+        record(event->name(), event->description(), nsecs);
+        return;
+    }
+
+    ThreadProfile &profile = threadProfile();
+    std::lock_guard<std::mutex> guard(profile.lock);
+
+    const char *description = event->description();
+    auto &slot = profile.byEvent[event];
+    if (!slot.second || slot.first != description) {
+        // references to the entries of a table stay valid as it grows
+        slot = {description,
+                &profile.events[keyOf(event->name(), description)]};
+    }
+    slot.second->nsecs += nsecs;
+    ++slot.second->samples;
+}
+
+void
+dump(std::ostream &os)
+{
+    Table events, objects;
+    uint64_t total_nsecs = 0, total_samples = 0;
+    {
+        std::lock_guard<std::mutex> guard(profilesLock);
+        for (ThreadProfile *profile : profiles) {
+            std::lock_guard<std::mutex> profile_guard(profile->lock);
+            for (const auto &event : profile->events) {
+                Entry &entry = events[event.first];
+                entry.nsecs += event.second.nsecs;
+                entry.samples += event.second.samples;
+            }
+        }
+    }
+    for (const auto &event : events) {
+        Entry &entry = objects[ownerOf(event.first)];
+        entry.nsecs += event.second.nsecs;
+        entry.samples += event.second.samples;
+        total_nsecs += event.second.nsecs;
+        total_samples += event.second.samples;
+    }
+
+    ccprintf(os, "\n---------- Begin Host Profile ----------\n");
+    ccprintf(os, "%-60s %14d\n", "host_ns", total_nsecs * samplePeriod);
+    ccprintf(os, "%-60s %14d\n", "events", total_samples * samplePeriod);
+    ccprintf(os, "%-60s %14d\n", "sample_period", samplePeriod);
+    printTable(os, "simobject", objects, total_nsecs);
+    printTable(os, "event", events, total_nsecs);
+    ccprintf(os, "\n---------- End Host Profile   ----------\n");
+}
+
+void
+dump()
+{
+    if (!samplePeriod || !output)
+        return;
+    dump(*output->stream());
+    output->stream()->flush();
+}
+
+void
+reset()
+{
+    std::lock_guard<std::mutex> guard(profilesLock);
+    for (ThreadProfile *profile : profiles) {
+        std::lock_guard<std::mutex> profile_guard(profile->lock);
+        profile->byEvent.clear();
+        profile->events.clear();
+    }
+}
+
+} // namespace host_profile
+} // namespace gem5
@@ -0,0 +1,69 @@
+/* @file
+ * Host time spent servicing events, per event and per SimObject
+ */
+
+#ifndef __SIM_HOST_PROFILE_HH__
+#define __SIM_HOST_PROFILE_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace gem5
+{
+
+class Event;
+
+namespace host_profile
+{
+
+/**
+ * Time one in every samplePeriod serviced events, or none if it is 0.
+ * With a period of 1 every event is timed.
+ */
+extern unsigned samplePeriod;
+
+/** Start profiling with the given sample period and output file. */
+void enable(unsigned period, const std::string &path);
+
+/**
+ * Account one sampled event to its name and to the SimObject that owns
+ * it, i.e. the name up to the last dot.
+ *
+ * @param name Name of the event.
+ * @param description Description of the event, used in place of the
+ *        name of events that have no meaningful one.
+ * @param nsecs Host time spent in Event::process().
+ */
+void record(const std::string &name, const char *description,
+            uint64_t nsecs);
+
+/**
+ * Account one sampled event, looking its name up only the first time
+ * the event is sampled, except for managed events whose memory may be
+ * reused by other events.
+ *
+ * @param event The event, which must not have been released yet.
+ * @param nsecs Host time spent in Event::process().
+ */
+void record(const Event *event, uint64_t nsecs);
+
+/**
+ * Print the profile accumulated since the last reset, scaled by the
+ * sample period, with the most expensive entries first.
+ */
+void dump(std::ostream &os);
+
+/** Append the profile to the output file, if profiling is enabled. */
+void dump();
+
+/**
+ * Discard the samples of all threads. This and dump() may be called
+ * while other threads record samples.
+ */
+void reset();
+
+} // namespace host_profile
+} // namespace gem5
+
+#endif // __SIM_HOST_PROFILE_HH__
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include "sim/eventq.hh"
+#include "sim/host_profile.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class HostProfileTest : public testing::Test
+{
+  protected:
+    void
+    TearDown() override
+    {
+        host_profile::samplePeriod = 0;
+        host_profile::reset();
+    }
+};
+
+/** Find the line of a table that starts with name. */
+std::string
+row(const std::string &profile, const std::string &name)
+{
+    std::istringstream is(profile);
+    std::string line;
+    while (std::getline(is, line)) {
+        if (line.compare(0, name.size() + 1, name + " ") == 0)
+            return line;
+    }
+    return "";
+}
+
+/** The numbers of a row, without its name and percentage. */
+std::string
+counts(const std::string &line)
+{
+    std::istringstream is(line);
+    std::string name, nsecs, percent, events;
+    is >> name >> nsecs >> percent >> events;
+    return nsecs + " " + events;
+}
+
+} // anonymous namespace
+
+/** Samples add up per event and per owning SimObject. */
+TEST_F(HostProfileTest, Aggregates)
+{
+    host_profile::samplePeriod = 1;
+    host_profile::record("system.cpu.tickEvent", "EventFunctionWrapped", 30);
+    host_profile::record("system.cpu.tickEvent", "EventFunctionWrapped", 10);
+    host_profile::record("system.cpu.fetchEvent", "EventFunctionWrapped", 5);
+    host_profile::record("system.l3.sendEvent", "EventFunctionWrapped", 100);
+    host_profile::record("Event_12", "generic", 7);
+    host_profile::record("Event_13", "generic", 3);
+
+    std::ostringstream os;
+    host_profile::dump(os);
+    const std::string profile = os.str();
+
+    EXPECT_EQ(counts(row(profile, "host_ns")), "155 ");
+    EXPECT_EQ(counts(row(profile, "system.cpu.tickEvent")), "40 2");
+    EXPECT_EQ(counts(row(profile, "system.cpu.fetchEvent")), "5 1");
+    EXPECT_EQ(counts(row(profile, "system.cpu")), "45 3");
+    EXPECT_EQ(counts(row(profile, "system.l3")), "100 1");
+    EXPECT_EQ(counts(row(profile, "generic")), "10 2");
+    EXPECT_EQ(counts(row(profile, "(none)")), "10 2");
+
+    // the most expensive SimObject comes first
+    EXPECT_LT(profile.find("system.l3 "), profile.find("system.cpu "));
+}
+
+/** Sampled counts are scaled up by the sample period. */
+TEST_F(HostProfileTest, ScalesSamples)
+{
+    host_profile::samplePeriod = 4;
+    host_profile::record("system.mem.nextReqEvent", "generic", 25);
+
+    std::ostringstream os;
+    host_profile::dump(os);
+    EXPECT_EQ(counts(row(os.str(), "system.mem.nextReqEvent")), "100 4");
+}
+
+/** Serviced events are profiled under their own names. */
+TEST_F(HostProfileTest, ServiceOne)
+{
+    EventQueue eq("test_eq");
+    int processed = 0;
+    EventFunctionWrapper tick([&]{ ++processed; }, "system.cpu.tickEvent");
+    EventFunctionWrapper send([&]{ ++processed; }, "system.bus.sendEvent");
+
+    host_profile::samplePeriod = 1;
+    for (Tick when = 1; when <= 3; when++) {
+        eq.schedule(&tick, when);
+        eq.serviceOne();
+    }
+    eq.schedule(&send, 4);
+    eq.serviceOne();
+    EXPECT_EQ(processed, 4);
+
+    std::ostringstream os;
+    host_profile::dump(os);
+    std::istringstream is(row(os.str(), "system.cpu.tickEvent"));
+    std::string name, nsecs, percent, events;
+    is >> name >> nsecs >> percent >> events;
+    EXPECT_EQ(events, "3");
+    EXPECT_EQ(counts(row(os.str(), "system.bus")), counts(row(os.str(),
+        "system.bus.sendEvent")));
+
+    // nothing is recorded once profiling is off
+    host_profile::reset();
+    host_profile::samplePeriod = 0;
+    eq.schedule(&tick, 5);
+    eq.serviceOne();
+    std::ostringstream off;
+    host_profile::dump(off);
+    EXPECT_EQ(row(off.str(), "system.cpu.tickEvent"), "");
+}
+
+/** An event sampled before a reset is recorded afresh after it. */
+TEST_F(HostProfileTest, RecordAfterReset)
+{
+    EventFunctionWrapper tick([]{}, "system.cpu.tickEvent");
+
+    host_profile::samplePeriod = 1;
+    host_profile::record(&tick, 20);
+    host_profile::reset();
+    host_profile::record(&tick, 5);
+    host_profile::record(&tick, 5);
+
+    std::ostringstream os;
+    host_profile::dump(os);
+    EXPECT_EQ(counts(row(os.str(), "system.cpu.tickEvent")), "10 2");
+}
@@ -41,6 +41,7 @@
 
 #include "base/hostinfo.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/trace.hh"
 #include "debug/TimeSync.hh"
 #include "sim/core.hh"
@@ -52,6 +53,20 @@
 namespace gem5
 {
 
+namespace
+{
+
+uint64_t
+numServicedEvents()
+{
+    uint64_t events = 0;
+    for (const EventQueue *queue : mainEventQueue)
+        events += queue->numServiced();
+    return events;
+}
+
+} // anonymous namespace
+
 Root *Root::_root = NULL;
 Root::RootStats Root::RootStats::instance;
 Root::RootStats &rootStats = Root::RootStats::instance;
@@ -73,11 +88,22 @@ Root::RootStats::RootStats()
     ADD_STAT(hostTickRate, statistics::units::Rate<
                 statistics::units::Tick, statistics::units::Second>::get(),
              "The number of ticks simulated per host second (ticks/s)"),
+    ADD_STAT(simEvents, statistics::units::Count::get(),
+             "Number of events processed by all event queues"),
+    ADD_STAT(hostEventRate, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Second>::get(),
+             "The number of events processed per host second (events/s)"),
     ADD_STAT(hostMemory, statistics::units::Byte::get(),
              "Number of bytes of host memory used"),
+    ADD_STAT(hostPoolAllocs, statistics::units::Count::get(),
+             "Number of packets and requests allocated from the host "
+             "memory pools"),
+    ADD_STAT(hostPoolMisses, statistics::units::Count::get(),
+             "Number of pool allocations that went to the host allocator"),
 
     statTime(true),
-    startTick(0)
+    startTick(0),
+    startEvents(0)
 {
     simFreq.scalar(sim_clock::Frequency);
     simTicks.functor([this]() { return curTick() - startTick; });
@@ -88,6 +114,13 @@ Root::RootStats::RootStats()
         .prereq(hostMemory)
         ;
 
+    hostPoolAllocs
+        .functor([]() { return pool_alloc::totals().allocs; })
+        .prereq(hostPoolAllocs)
+        ;
+
+    hostPoolMisses.functor([]() { return pool_alloc::totals().misses; });
+
     hostSeconds
         .functor([this]() {
                 Time now;
@@ -97,10 +130,14 @@ Root::RootStats::RootStats()
         .precision(2)
         ;
 
+    simEvents.functor([this]() { return numServicedEvents() - startEvents; });
+
     hostTickRate.precision(0);
+    hostEventRate.precision(0);
 
     simSeconds = simTicks / simFreq;
     hostTickRate = simTicks / hostSeconds;
+    hostEventRate = simEvents / hostSeconds;
 }
 
 void
@@ -108,6 +145,7 @@ Root::RootStats::resetStats()
 {
     statTime.setTimer();
     startTick = curTick();
+    startEvents = numServicedEvents();
 
     statistics::Group::resetStats();
 }
@@ -188,6 +226,11 @@ Root::Root(const RootParams &p, int)
 
     simQuantum = p.sim_quantum;
 
+    // queues created from now on pick the setting up themselves
+    calendarEventQueues = p.calendar_event_queue;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->enableCalendar(calendarEventQueues);
+
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
     // having a single global stat group for global stats. Merge that
@@ -108,7 +108,11 @@ class Root : public SimObject
         statistics::Value hostSeconds;
 
         statistics::Formula hostTickRate;
+        statistics::Value simEvents;
+        statistics::Formula hostEventRate;
         statistics::Value hostMemory;
+        statistics::Value hostPoolAllocs;
+        statistics::Value hostPoolMisses;
 
         static RootStats instance;
 
@@ -120,6 +124,7 @@ class Root : public SimObject
 
         Time statTime;
         Tick startTick;
+        uint64_t startEvents;
     };
 
   public:
@@ -55,7 +55,10 @@ from testlib.configuration import (
     config,
     constants,
 )
-from testlib.fixture import Fixture
+from testlib.fixture import (
+    Fixture,
+    SkipException,
+)
 from testlib.helper import (
     absdirpath,
     cacheresult,
@@ -101,6 +104,30 @@ class TempdirFixture(Fixture):
             shutil.rmtree(self.path)
 
 
+class HostPerfBaseline(Fixture):
+    """
+    The host performance baseline a test is checked against. The test is
+    skipped if the baseline was not recorded, unless GEM5_HOST_PERF_UPDATE
+    is set to record it.
+    """
+
+    def __init__(self, path: str):
+        super().__init__(name=f"host performance baseline {path}")
+        self.path = path
+
+    def setup(self, testitem):
+        if os.environ.get("GEM5_HOST_PERF_UPDATE") or os.path.isfile(
+            self.path
+        ):
+            return
+        log.test_log.message(
+            f"Skipping {testitem.metadata.name}: no host performance "
+            + f"baseline {self.path}, run with GEM5_HOST_PERF_UPDATE=1 to "
+            + "record one"
+        )
+        raise SkipException(self, testitem.metadata)
+
+
 class UniqueFixture(Fixture):
     """
     Base class for fixtures that generate a target in the
@@ -0,0 +1,225 @@
+"""
+Runs a fixed, kernel-free workload against DRAM behind a CXL memory device
+and reports how fast the host simulated it.
+
+The workload is either a traffic generator or a syscall-emulation binary,
+and its memory, code included, lives entirely on the CXL device. When the
+simulation ends, the host performance of the run is written to
+host_perf.json in the output directory:
+
+    {
+        "benchmark": "<workload>-<cpu>-<cache>[-filtered]",
+        "stats_filter": [...],
+        "host_instantiate_seconds": ...,
+        "host_startup_phases": {...},
+        "host_seconds": ...,
+        "host_mem_usage": ...,
+        "sim_ticks": ...,
+        "sim_insts": ...,
+        "sim_events": ...,
+        "host_inst_rate": ...,
+        "host_tick_rate": ...,
+        "host_event_rate": ...
+    }
+"""
+
+import argparse
+import json
+import re
+import time
+from pathlib import Path
+
+import m5
+from m5.objects import Root
+
+from gem5.components.memory.cxl_expander import CXLExpander
+from gem5.components.memory.single_channel import SingleChannelDDR4_2400
+from gem5.isas import ISA
+from gem5.resources.resource import BinaryResource
+
+
+def cache_factory(cache_class: str):
+    if cache_class == "NoCache":
+        from gem5.components.cachehierarchies.classic.no_cache import NoCache
+
+        return NoCache()
+    elif cache_class == "PrivateL1PrivateL2":
+        from gem5.components.cachehierarchies.classic.private_l1_private_l2_cache_hierarchy import (
+            PrivateL1PrivateL2CacheHierarchy,
+        )
+
+        return PrivateL1PrivateL2CacheHierarchy(
+            l1d_size="32KiB", l1i_size="32KiB", l2_size="256KiB"
+        )
+    elif cache_class == "MESITwoLevel":
+        from gem5.components.cachehierarchies.ruby.mesi_two_level_cache_hierarchy import (
+            MESITwoLevelCacheHierarchy,
+        )
+
+        return MESITwoLevelCacheHierarchy(
+            l1i_size="32KiB",
+            l1i_assoc="8",
+            l1d_size="32KiB",
+            l1d_assoc="8",
+            l2_size="256KiB",
+            l2_assoc="4",
+            num_l2_banks=1,
+        )
+    else:
+        raise ValueError(f"The cache class {cache_class} is not supported.")
+
+
+def read_stats(path: Path) -> dict:
+    """Return the values of the last dump in a stats.txt file."""
+    stats = {}
+    for line in path.read_text().splitlines():
+        if line.startswith("---------- Begin Simulation Statistics"):
+            stats = {}
+        match = re.match(r"^(\S+)\s+(\S+)", line)
+        if match:
+            try:
+                stats[match.group(1)] = float(match.group(2))
+            except ValueError:
+                pass
+    return stats
+
+
+parser = argparse.ArgumentParser(
+    description="Measures the host performance of a kernel-free workload "
+    "on CXL memory."
+)
+
+parser.add_argument(
+    "workload",
+    type=str,
+    help="The traffic generator to use, or se to run a binary.",
+    choices=["LinearGenerator", "RandomGenerator", "se"],
+)
+
+parser.add_argument(
+    "cache_class",
+    type=str,
+    help="The cache hierarchy to put in front of the CXL memory.",
+    choices=["NoCache", "PrivateL1PrivateL2", "MESITwoLevel"],
+)
+
+parser.add_argument(
+    "--cpu",
+    type=str,
+    default="timing",
+    choices=["timing", "o3"],
+    help="The CPU model running the binary of the se workload.",
+)
+
+parser.add_argument(
+    "--binary",
+    type=str,
+    help="The binary the se workload runs.",
+)
+
+parser.add_argument(
+    "--mem-size",
+    type=str,
+    default="512MiB",
+    help="The size of the memory behind the CXL device.",
+)
+
+parser.add_argument(
+    "--stats-filter",
+    type=str,
+    action="append",
+    default=[],
+    help="Only keep the stats matching this glob, and the simulator's "
+    "own stats. May be given several times.",
+)
+
+args = parser.parse_args()
+
+memory = CXLExpander(SingleChannelDDR4_2400(args.mem_size))
+cache_hierarchy = cache_factory(args.cache_class)
+
+if args.workload == "se":
+    from gem5.components.boards.simple_board import SimpleBoard
+    from gem5.components.processors.cpu_types import get_cpu_type_from_str
+    from gem5.components.processors.simple_processor import SimpleProcessor
+
+    if not args.binary:
+        parser.error("the se workload needs --binary")
+    if args.cache_class == "NoCache":
+        parser.error("the se workload needs caches")
+
+    processor = SimpleProcessor(
+        cpu_type=get_cpu_type_from_str(args.cpu), num_cores=1, isa=ISA.X86
+    )
+    board = SimpleBoard(
+        clk_freq="3GHz",
+        processor=processor,
+        memory=memory,
+        cache_hierarchy=cache_hierarchy,
+    )
+    board.set_se_binary_workload(BinaryResource(local_path=args.binary))
+    benchmark = f"{Path(args.binary).name}-{args.cpu}-{args.cache_class}"
+else:
+    from gem5.components.boards.test_board import TestBoard
+
+    if args.workload == "LinearGenerator":
+        from gem5.components.processors.linear_generator import (
+            LinearGenerator as generator_class,
+        )
+    else:
+        from gem5.components.processors.random_generator import (
+            RandomGenerator as generator_class,
+        )
+
+    generator = generator_class(
+        duration="250us",
+        rate="40GB/s",
+        num_cores=1,
+        max_addr=memory.get_size(),
+    )
+    board = TestBoard(
+        clk_freq="3GHz",
+        generator=generator,
+        memory=memory,
+        cache_hierarchy=cache_hierarchy,
+    )
+    benchmark = f"{args.workload}-{args.cache_class}"
+
+if args.stats_filter:
+    # the host performance is read from the root stats
+    m5.stats.setFilter(args.stats_filter + ["sim*", "host*"])
+    benchmark += "-filtered"
+
+root = Root(full_system=False, system=board)
+
+start = time.perf_counter()
+board._pre_instantiate()
+m5.instantiate()
+instantiate_seconds = time.perf_counter() - start
+
+if args.workload != "se":
+    generator.start_traffic()
+
+print("Beginning simulation!")
+exit_event = m5.simulate()
+print(f"Exiting @ tick {m5.curTick()} because {exit_event.getCause()}.")
+
+m5.stats.dump()
+stats = read_stats(Path(m5.options.outdir) / m5.options.stats_file)
+
+host_perf = {
+    "benchmark": benchmark,
+    "stats_filter": args.stats_filter,
+    "host_instantiate_seconds": instantiate_seconds,
+    "host_startup_phases": m5.startup_phases,
+    "host_seconds": stats["hostSeconds"],
+    "host_mem_usage": stats["hostMemory"],
+    "sim_ticks": stats["simTicks"],
+    "sim_insts": stats.get("simInsts", 0),
+    "sim_events": stats["simEvents"],
+    "host_inst_rate": stats.get("hostInstRate", 0),
+    "host_tick_rate": stats["hostTickRate"],
+    "host_event_rate": stats["hostEventRate"],
+}
+with open(Path(m5.options.outdir) / "host_perf.json", "w") as perf_file:
+    json.dump(host_perf, perf_file, indent=2)
@@ -0,0 +1,84 @@
+"""
+Measures how fast the host simulates fixed, kernel-free workloads on CXL
+memory, and catches drops in that speed.
+
+Each run writes its host performance to host_perf.json. The CheckHostPerf
+verifier compares it to a baseline recorded on the same host, in the
+subdirectory named after the host of the directory named by
+GEM5_HOST_PERF_BASELINES (by default, baselines/ next to this file). Tests
+without a baseline are skipped. Set GEM5_HOST_PERF_UPDATE=1 to record new
+baselines in the output directories instead.
+"""
+
+import os
+import socket
+
+from testlib import *
+
+baseline_dir = joinpath(
+    os.environ.get(
+        "GEM5_HOST_PERF_BASELINES",
+        joinpath(config.base_dir, "tests", "gem5", "host_perf", "baselines"),
+    ),
+    socket.gethostname(),
+)
+
+config_path = joinpath(
+    config.base_dir,
+    "tests",
+    "gem5",
+    "host_perf",
+    "configs",
+    "cxl_host_perf_run.py",
+)
+
+
+# The stats kept by the filtered runs.
+cxl_stats = "board.memory.bridge.link*"
+
+
+def test_host_perf(name: str, config_args, fixtures=()) -> None:
+    baseline = joinpath(baseline_dir, f"{name}.json")
+    gem5_verify_config(
+        name=f"test-host-perf-{name}",
+        fixtures=(HostPerfBaseline(baseline),) + tuple(fixtures),
+        verifiers=(verifier.CheckHostPerf(baseline),),
+        config=config_path,
+        config_args=config_args,
+        valid_isas=(constants.all_compiled_tag,),
+        valid_hosts=constants.supported_hosts,
+        length=constants.long_tag,
+    )
+
+
+# Traffic generators against the CXL device, without caches, through a
+# classic hierarchy and through Ruby.
+for generator in ("LinearGenerator", "RandomGenerator"):
+    for cache in ("NoCache", "PrivateL1PrivateL2", "MESITwoLevel"):
+        test_host_perf(f"{generator}-{cache}", [generator, cache])
+
+    # The same, keeping only the CXL link stats, to compare their host
+    # time with the unfiltered runs
+    for cache in ("NoCache", "PrivateL1PrivateL2"):
+        test_host_perf(
+            f"{generator}-{cache}-filtered",
+            [generator, cache, f"--stats-filter={cxl_stats}"],
+        )
+
+# The CPU tests' microbenchmarks, with all their memory on the CXL device.
+base_path = joinpath(config.bin_path, "cpu_tests", "x86")
+base_url = config.resource_url + "/test-progs/cpu-tests/bin/x86"
+
+for workload in ("Bubblesort", "FloatMM"):
+    workload_binary = DownloadedProgram(
+        base_url + "/" + workload, base_path, workload
+    )
+    binary = joinpath(workload_binary.path, workload)
+
+    for cpu in ("timing", "o3"):
+        for cache in ("PrivateL1PrivateL2", "MESITwoLevel"):
+            test_host_perf(
+                f"{workload}-{cpu}-{cache}",
+                ["se", cache, f"--cpu={cpu}", f"--binary={binary}"],
+                fixtures=(workload_binary,),
+            )
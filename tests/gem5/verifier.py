@@ -43,7 +43,9 @@ Built in test cases that verify particular details about a gem5 run.
 import json
 import os
 import re
+import shutil
 
+import testlib.log as log
 from testlib import test_util
 from testlib.configuration import constants
 from testlib.helper import (
@@ -332,6 +334,88 @@ class MatchJSONStats(Verifier):
         return self._compare_stats(trusted_file, test_file)
 
 
+class CheckHostPerf(Verifier):
+    """
+    Verifier that checks the host performance a run reports in a JSON file
+    against a baseline recorded on the same host. It fails if a rate drops,
+    or the host memory use grows, by more than the tolerance, or if there is
+    no baseline.
+
+    If GEM5_HOST_PERF_UPDATE is set, the results of the run are written to
+    the output directory as a new baseline, to be copied over the old one,
+    instead of being checked.
+    """
+
+    # Metrics where higher is better
+    rates = ("host_inst_rate", "host_tick_rate", "host_event_rate")
+    # Metrics where lower is better
+    costs = ("host_mem_usage",)
+
+    def __init__(
+        self,
+        baseline: str,
+        result: str = "host_perf.json",
+        tolerance: float = 0.1,
+    ):
+        """
+        :param baseline: The path to the baseline JSON file.
+        :param result: The name of the JSON file in the output directory.
+        :param tolerance: The fraction a metric may get worse by.
+        """
+        super().__init__()
+        self.baseline = baseline
+        self.result = result
+        self.tolerance = tolerance
+
+    def test(self, params):
+        tempdir = params.fixtures[constants.tempdir_fixture_name].path
+        result_file = joinpath(tempdir, self.result)
+        if not os.path.isfile(result_file):
+            test_util.fail(f"Could not find host performance {result_file}")
+        with open(result_file) as f:
+            result = json.load(f)
+
+        if os.environ.get("GEM5_HOST_PERF_UPDATE"):
+            new_baseline = joinpath(
+                tempdir, "baseline-" + os.path.basename(self.baseline)
+            )
+            shutil.copyfile(result_file, new_baseline)
+            log.test_log.message(
+                f"Recorded host performance baseline {new_baseline}, "
+                + f"copy it from the output directory to {self.baseline}"
+            )
+            return
+
+        if not os.path.isfile(self.baseline):
+            test_util.fail(
+                f"Could not find host performance baseline {self.baseline}, "
+                + "run with GEM5_HOST_PERF_UPDATE=1 to record one"
+            )
+
+        with open(self.baseline) as f:
+            baseline = json.load(f)
+
+        err = ""
+        for metric in self.rates + self.costs:
+            expected = baseline.get(metric, 0)
+            actual = result.get(metric, 0)
+            if not expected:
+                continue
+            if metric in self.rates:
+                worse = actual < expected * (1 - self.tolerance)
+            else:
+                worse = actual > expected * (1 + self.tolerance)
+            if worse:
+                err += (
+                    f"{metric}: baseline {expected}, measured {actual} "
+                    + f"({(actual - expected) / expected:+.1%})\n"
+                )
+        if err:
+            test_util.fail(
+                f"Host performance regressed against {self.baseline}:\n" + err
+            )
+
+
 _re_type = type(re.compile(""))
 
 
@@ -0,0 +1,172 @@
+import math
+import tempfile
+import unittest
+from unittest import mock
+
+from gem5.simulate import sampling
+from gem5.simulate.sampling import (
+    SampledMetric,
+    SmartsSampler,
+)
+
+
+class SampledMetricTestSuite(unittest.TestCase):
+    """Tests the simulate.sampling.SampledMetric class."""
+
+    def test_mean_and_interval(self) -> None:
+        metric = SampledMetric("ips", confidence=0.95)
+        metric.samples = [1.0, 2.0, 3.0, 4.0, 5.0]
+
+        self.assertAlmostEqual(3.0, metric.mean())
+        self.assertAlmostEqual(math.sqrt(2.5), metric.stdev())
+        # z of a 95% two-sided interval, times the standard error
+        self.assertAlmostEqual(
+            1.959964 * math.sqrt(2.5) / math.sqrt(5),
+            metric.interval(),
+            places=5,
+        )
+
+    def test_confidence_widens_interval(self) -> None:
+        narrow = SampledMetric("ips", confidence=0.9)
+        wide = SampledMetric("ips", confidence=0.99)
+        narrow.samples = wide.samples = [2.0, 4.0, 4.0, 6.0]
+
+        self.assertLess(narrow.interval(), wide.interval())
+
+    def test_too_few_samples(self) -> None:
+        metric = SampledMetric("ips", confidence=0.95)
+        self.assertTrue(math.isnan(metric.mean()))
+
+        metric.samples = [7.0]
+        self.assertEqual(7.0, metric.mean())
+        self.assertTrue(math.isnan(metric.stdev()))
+        self.assertTrue(math.isnan(metric.interval()))
+
+    def test_to_json(self) -> None:
+        metric = SampledMetric("ips", confidence=0.95)
+        metric.samples = [8.0, 10.0, 12.0]
+        json_contents = metric.to_json()
+
+        self.assertEqual(10.0, json_contents["mean"])
+        self.assertEqual(2.0, json_contents["stdev"])
+        self.assertEqual(0.95, json_contents["confidence"])
+        self.assertAlmostEqual(
+            json_contents["interval"] / 10.0,
+            json_contents["relative_error"],
+        )
+        self.assertEqual([8.0, 10.0, 12.0], json_contents["samples"])
+
+
+class FakeProcessor:
+    """The parts of a SwitchableProcessor the sampler uses."""
+
+    def __init__(self, calls) -> None:
+        self._switchable_cores = {"start": ["atomic"], "switch": ["o3"]}
+        self._current_cores = self._switchable_cores["start"]
+        self._calls = calls
+
+    def switch_to_processor(self, cores: str) -> None:
+        self._calls.append(("switch", cores))
+        self._current_cores = self._switchable_cores[cores]
+
+
+class SmartsSamplerTestSuite(unittest.TestCase):
+    """
+    Tests the phases the simulate.sampling.SmartsSampler goes through on
+    each SCHEDULED_TICK exit, with the simulator functions it calls mocked.
+    """
+
+    def setUp(self) -> None:
+        self.calls = []
+        self.tick = 0
+        self.insts = 0
+        self.outdir = tempfile.TemporaryDirectory()
+
+        def schedule(ticks):
+            self.calls.append(("schedule", ticks))
+
+        patches = [
+            mock.patch.object(
+                sampling.m5, "scheduleTickExitFromCurrent", schedule
+            ),
+            mock.patch.object(sampling.m5, "curTick", lambda: self.tick),
+            mock.patch.object(sampling.m5.ticks, "getFrequency", lambda: 1000),
+            mock.patch.object(
+                sampling.m5.stats,
+                "reset",
+                lambda: self.calls.append(("reset",)),
+            ),
+            mock.patch.object(
+                sampling.m5.stats,
+                "dump",
+                lambda: self.calls.append(("dump",)),
+            ),
+            mock.patch.object(sampling, "_root_stat", lambda name: self.insts),
+            mock.patch.object(sampling.m5.options, "outdir", self.outdir.name),
+            mock.patch.object(sampling, "inform", lambda message: None),
+        ]
+        for patch in patches:
+            patch.start()
+            self.addCleanup(patch.stop)
+        self.addCleanup(self.outdir.cleanup)
+
+    def test_phase_order(self) -> None:
+        sampler = SmartsSampler(
+            processor=FakeProcessor(self.calls),
+            period=100,
+            detailed_warmup=10,
+            measurement=20,
+            num_samples=2,
+            metrics={"misses": lambda: 3.0},
+        )
+        sampler._start()
+        run = sampler._run()
+
+        for sample in range(2):
+            # end of the fast-forward
+            self.assertFalse(next(run))
+            # end of the detailed warm-up, the measurement starts at tick 10
+            # of the sample with 0 instructions
+            self.tick, self.insts = 10, 0
+            self.assertFalse(next(run))
+            # end of the measured interval, 20 ticks and 40 instructions on
+            self.tick, self.insts = 30, 40
+            if sample == 0:
+                self.assertFalse(next(run))
+        self.assertTrue(next(run))
+
+        one_sample = [
+            ("switch", "switch"),
+            ("schedule", 10),
+            ("reset",),
+            ("schedule", 20),
+            ("dump",),
+            ("switch", "start"),
+        ]
+        self.assertEqual(
+            [("schedule", 70)] + one_sample + [("schedule", 70)] + one_sample,
+            self.calls,
+        )
+
+        # 40 instructions in 20 ticks of 1 ms
+        metrics = sampler.get_metrics()
+        self.assertEqual([2000.0, 2000.0], metrics["ips"].samples)
+        self.assertEqual([3.0, 3.0], metrics["misses"].samples)
+
+    def test_invalid_lengths(self) -> None:
+        with self.assertRaises(ValueError):
+            SmartsSampler(
+                processor=FakeProcessor(self.calls),
+                period=100,
+                detailed_warmup=40,
+                measurement=60,
+                num_samples=2,
+            )
+        with self.assertRaises(ValueError):
+            SmartsSampler(
+                processor=FakeProcessor(self.calls),
+                period=100,
+                detailed_warmup=10,
+                measurement=20,
+                num_samples=0,
+            )
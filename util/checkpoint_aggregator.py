@@ -29,7 +29,9 @@
 import gzip
 import os
 import re
+import struct
 import sys
+import zlib
 from configparser import ConfigParser
 
 
@@ -41,6 +43,86 @@ class myCP(ConfigParser):
         return optionstr
 
 
+class ChunkedStore:
+    """
+    Sequential reader of the chunked image of a backing store that gem5
+    writes to checkpoints, see src/mem/chunked_store.hh.
+    """
+
+    header = struct.Struct("=8sIIIIQQ")
+
+    def __init__(self, path):
+        self.file = open(path, "rb")
+        (
+            magic,
+            version,
+            self.page_bytes,
+            self.chunk_pages,
+            _,
+            self.size,
+            num_chunks,
+        ) = self.header.unpack(self.file.read(self.header.size))
+        if magic != b"gem5chk\0" or version != 1:
+            raise ValueError(f"{path} is not a chunked store file")
+
+        # offset, compressed size and bitmap of the stored pages
+        chunk = struct.Struct(f"=QQ{self.chunk_pages // 64}Q")
+        self.chunks = [
+            chunk.unpack(self.file.read(chunk.size)) for _ in range(num_chunks)
+        ]
+        self.pages = self._pages()
+        self.buffer = b""
+
+    def _pages(self):
+        addr = 0
+        for offset, size, *stored in self.chunks:
+            data = b""
+            if size:
+                self.file.seek(offset)
+                data = zlib.decompress(self.file.read(size))
+            pos = 0
+            for page in range(self.chunk_pages):
+                if addr >= self.size:
+                    return
+                page_size = min(self.page_bytes, self.size - addr)
+                if stored[page // 64] >> (page % 64) & 1:
+                    yield data[pos : pos + page_size]
+                    pos += page_size
+                else:
+                    yield bytes(page_size)
+                addr += page_size
+
+    def read(self, size):
+        while len(self.buffer) < size:
+            page = next(self.pages, None)
+            if page is None:
+                break
+            self.buffer += page
+        data, self.buffer = self.buffer[:size], self.buffer[size:]
+        return data
+
+    def close(self):
+        self.file.close()
+
+
+def open_store(cpt_dir, config):
+    """
+    Open the image of the first backing store of a checkpoint, gzipped in
+    older checkpoints and chunked in newer ones.
+    """
+    sec = "system.physmem.store0"
+    filename = config.get(
+        sec, "filename", fallback="system.physmem.store0.pmem"
+    )
+    store_format = config.get(sec, "store_format", fallback="gz")
+    path = os.path.join(cpt_dir, filename)
+    if store_format == "gz":
+        return gzip.open(path, "rb")
+    if store_format == "chunked":
+        return ChunkedStore(path)
+    raise ValueError(f"Unknown format '{store_format}' of {path}")
+
+
 def aggregate(output_dir, cpts, no_compress, memory_size):
     merged_config = None
     page_ptr = 0
@@ -50,7 +132,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         os.system("mkdir -p " + output_path)
 
     agg_mem_file = open(output_path + "/system.physmem.store0.pmem", "wb+")
-    agg_config_file = open(output_path + "/m5.cpt", "wb+")
+    agg_config_file = open(output_path + "/m5.cpt", "w+")
 
     if not no_compress:
         merged_mem = gzip.GzipFile(fileobj=agg_mem_file, mode="wb")
@@ -62,7 +144,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         print(arg)
         merged_config = myCP()
         config = myCP()
-        config.readfp(open(cpts[i] + "/m5.cpt"))
+        config.read_file(open(cpts[i] + "/m5.cpt"))
 
         for sec in config.sections():
             if re.compile("cpu").search(sec):
@@ -73,13 +155,15 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
                 for item in items:
                     if item[0] == "paddr":
                         merged_config.set(
-                            newsec, item[0], int(item[1]) + (page_ptr << 12)
+                            newsec,
+                            item[0],
+                            str(int(item[1]) + (page_ptr << 12)),
                         )
                         continue
                     merged_config.set(newsec, item[0], item[1])
 
                 if re.compile("workload.FdMap256$").search(sec):
-                    merged_config.set(newsec, "M5_pid", i)
+                    merged_config.set(newsec, "M5_pid", str(i))
 
             elif sec == "system":
                 pass
@@ -101,8 +185,7 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
         page_ptr = page_ptr + pages
         print("pages to be read: ", pages)
 
-        f = open(cpts[i] + "/system.physmem.store0.pmem", "rb")
-        gf = gzip.GzipFile(fileobj=f, mode="rb")
+        gf = open_store(cpts[i], config)
 
         x = 0
         while x < pages:
@@ -114,14 +197,13 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
             x += 1
 
         gf.close()
-        f.close()
 
     merged_config.add_section("system")
-    merged_config.set("system", "pagePtr", page_ptr)
-    merged_config.set("system", "nextPID", len(cpts))
+    merged_config.set("system", "pagePtr", str(page_ptr))
+    merged_config.set("system", "nextPID", str(len(cpts)))
 
     file_size = page_ptr * 4 * 1024
-    dummy_data = "".zfill(4096)
+    dummy_data = bytes(4096)
     while file_size < memory_size:
         if not no_compress:
             merged_mem.write(dummy_data)
@@ -136,11 +218,17 @@ def aggregate(output_dir, cpts, no_compress, memory_size):
     )
     print(page_ptr, "x 4K of memory")
     merged_config.set(
-        "system.physmem.store0", "range_size", page_ptr * 4 * 1024
+        "system.physmem.store0", "range_size", str(page_ptr * 4 * 1024)
+    )
+    # The merged image is a gzipped (or, uncompressed, a raw) image, which
+    # gem5 restores as the gz store format.
+    merged_config.set(
+        "system.physmem.store0", "filename", "system.physmem.store0.pmem"
     )
+    merged_config.set("system.physmem.store0", "store_format", "gz")
 
     merged_config.add_section("Globals")
-    merged_config.set("Globals", "curTick", max_curtick)
+    merged_config.set("Globals", "curTick", str(max_curtick))
 
     merged_config.write(agg_config_file)
 
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+
+# Print the records of a binary trace written with --debug-binary-file.
+#
+# The records of each simulation thread are in tick order, and the
+# threads are merged by tick. Each record is printed in the format of
+# the debug output:
+#
+#   <tick>: <object>: <event>: <cmd> addr <addr> arg <arg>
+#
+# or, with --csv, as comma separated values.
+
+import argparse
+import heapq
+import struct
+import sys
+
+MAGIC = b"gem5btr\0"
+FILE_HEADER = struct.Struct("<8sII")
+BLOCK_HEADER = struct.Struct("<IIQ")
+RECORD = struct.Struct("<QQQIHH")
+
+OBJECT_NAME = 1
+EVENT_NAME = 2
+CMD_NAME = 3
+RECORDS = 4
+
+
+def read_trace(path):
+    """Return the name tables and the records of each thread."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, record_size = FILE_HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit(f"{path} is not a binary trace")
+    if version != 1 or record_size != RECORD.size:
+        sys.exit(f"Unsupported binary trace version {version}")
+
+    names = {OBJECT_NAME: {}, EVENT_NAME: {}, CMD_NAME: {}}
+    threads = {}
+    pos = FILE_HEADER.size
+    while pos + BLOCK_HEADER.size <= len(data):
+        kind, ident, size = BLOCK_HEADER.unpack_from(data, pos)
+        pos += BLOCK_HEADER.size
+        if kind == RECORDS:
+            end = pos + size * RECORD.size
+            threads.setdefault(ident, []).extend(
+                RECORD.iter_unpack(data[pos:end])
+            )
+            pos = end
+        else:
+            names[kind][ident] = data[pos : pos + size].decode()
+            pos += size
+
+    return names, threads
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Print the records of a binary trace"
+    )
+    parser.add_argument("trace", help="binary trace file")
+    parser.add_argument(
+        "--csv", action="store_true", help="print comma separated values"
+    )
+    parser.add_argument(
+        "--object", action="append", help="only print records of OBJECT"
+    )
+    args = parser.parse_args()
+
+    names, threads = read_trace(args.trace)
+    objects = names[OBJECT_NAME]
+    events = names[EVENT_NAME]
+    cmds = names[CMD_NAME]
+
+    if args.csv:
+        print("tick,object,event,cmd,addr,arg")
+
+    records = heapq.merge(*threads.values(), key=lambda r: r[0])
+    for tick, addr, arg, obj, event, cmd in records:
+        obj_name = objects.get(obj, str(obj))
+        if args.object and obj_name not in args.object:
+            continue
+        event_name = events.get(event, str(event))
+        cmd_name = cmds.get(cmd, str(cmd))
+        if args.csv:
+            print(f"{tick},{obj_name},{event_name},{cmd_name},{addr:#x},{arg}")
+        else:
+            print(
+                f"{tick:7d}: {obj_name}: {event_name}: {cmd_name} "
+                f"addr {addr:#x} arg {arg}"
+            )
+
+
+if __name__ == "__main__":
+    main()
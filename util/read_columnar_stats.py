@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+# Read the stats written by a columnar:// stat output.
+#
+# As a module, read_stats() returns the column names, their units, the
+# tick of each dump and the rows of values. With numpy installed, the
+# ticks and rows are arrays, with one row per dump and one column per
+# stat. The file is little endian on every host.
+#
+# As a script, the selected columns are printed as comma separated
+# values, one line per dump:
+#
+#   read_columnar_stats.py m5out/stats.col.gz 'cxl.*bandwidth' 'simTicks'
+
+import argparse
+import csv
+import gzip
+import re
+import struct
+import sys
+
+MAGIC = b"gem5col\0"
+FILE_HEADER = struct.Struct("<8sII")
+LENGTH = struct.Struct("<I")
+TICK = struct.Struct("<Q")
+
+
+def read_stats(path):
+    """Return the names, units, ticks and rows of a columnar stat file."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:2] == b"\x1f\x8b":
+        data = gzip.decompress(data)
+
+    magic, version, columns = FILE_HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError(f"{path} is not a columnar stat file")
+    if version != 1:
+        raise ValueError(f"Unsupported columnar stat file version {version}")
+
+    pos = FILE_HEADER.size
+
+    def read_string():
+        nonlocal pos
+        (size,) = LENGTH.unpack_from(data, pos)
+        pos += LENGTH.size
+        pos += size
+        return data[pos - size : pos].decode()
+
+    names = []
+    units = []
+    for _ in range(columns):
+        names.append(read_string())
+        units.append(read_string())
+
+    row = struct.Struct(f"<Q{columns}d")
+    dumps = (len(data) - pos) // row.size
+    end = pos + dumps * row.size
+
+    try:
+        import numpy
+    except ImportError:
+        ticks = []
+        rows = []
+        for values in row.iter_unpack(data[pos:end]):
+            ticks.append(values[0])
+            rows.append(values[1:])
+        return names, units, ticks, rows
+
+    table = numpy.frombuffer(
+        data,
+        dtype=numpy.dtype([("tick", "<u8"), ("values", "<f8", (columns,))]),
+        count=dumps,
+        offset=pos,
+    )
+    return names, units, table["tick"], table["values"]
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Print the columns of a columnar stat file as comma "
+        "separated values."
+    )
+    parser.add_argument("file", help="The columnar stat file.")
+    parser.add_argument(
+        "columns",
+        nargs="*",
+        help="Regular expressions selecting the columns to print, all "
+        "columns by default.",
+    )
+    parser.add_argument(
+        "--list",
+        action="store_true",
+        help="List the columns and their units instead.",
+    )
+    args = parser.parse_args()
+
+    try:
+        names, units, ticks, rows = read_stats(args.file)
+    except ValueError as e:
+        sys.exit(str(e))
+
+    if args.list:
+        for name, unit in zip(names, units):
+            print(f"{name} ({unit})")
+        return
+
+    patterns = [re.compile(c) for c in args.columns]
+    selected = [
+        i
+        for i, name in enumerate(names)
+        if not patterns or any(p.search(name) for p in patterns)
+    ]
+
+    writer = csv.writer(sys.stdout)
+    writer.writerow(["tick"] + [names[i] for i in selected])
+    for tick, values in zip(ticks, rows):
+        writer.writerow([int(tick)] + [values[i] for i in selected])
+
+
+if __name__ == "__main__":
+    main()